@@ -0,0 +1,1348 @@
+/*
+	   .
+
+		perfomance_benchmark [--quick] [--filter <>] [--output <>]
+		perfomance_benchmark --verify
+
+	    JSON    (, , p50  p99 
+	  )      .  
+	    2 ,      
+	  .    heap_counter   .
+
+	,    ,       (
+	/proc/stat  1..1024 ),        - 
+	       loopback. , 
+	    (perf_event, cgroup v2, netlink), 
+	  "skipped".     ,  -  
+	.
+
+	 --verify   :  cpu, sched, io  cpufreq 
+	     , recorder  
+	   ,      .
+*/
+#define BOOST_PERFOMANCE_WITH_EXPORTER
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <boost/chrono.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/container/vector.hpp>
+#include <boost/thread.hpp>
+#include "../perfomance.hpp"
+#include "../detail/sampler.hpp"
+#include "../detail/load_kernel.hpp"
+#include "../detail/linux/network_counter.hpp"
+#include "../detail/linux/interface_counter.hpp"
+#include "../detail/linux/cgroup_counter.hpp"
+#include "../detail/linux/topology.hpp"
+#include "../detail/linux/process_scanner.hpp"
+#include "../detail/linux/thread_counter.hpp"
+#include "../detail/linux/sched_counter.hpp"
+#include "../detail/linux/io_counter.hpp"
+#include "../detail/linux/cpufreq_counter.hpp"
+#include "../detail/heap_counter_hooks.hpp"
+
+namespace {
+
+namespace detail = boost::perfomance::detail;
+namespace linux_ = boost::perfomance::detail::linux_;
+
+/*
+	     
+*/
+class benchmark_runner {
+private:
+	FILE* output;
+	const char* filter;
+	bool quick;
+	bool first_result;
+	unsigned long failures;
+	std::vector<double> samples;
+
+	static boost::uint64_t now() {
+		return (boost::uint64_t)boost::chrono::duration_cast<boost::chrono::nanoseconds>(boost::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	std::size_t max_samples() const {
+		return quick ? 32 : 2000;
+	}
+
+	boost::uint64_t time_budget() const {
+		return quick ? 20000000ull : 500000000ull;
+	}
+
+	void begin_result(const char* name, const char* params) {
+		std::fprintf(output, "%s\n\t\t{\"name\": \"%s\", \"params\": {%s}", first_result ? "" : ",", name, params);
+		first_result = false;
+	}
+
+public:
+	benchmark_runner(FILE* output_file, const char* name_filter, bool quick_run)
+		: output(output_file), filter(name_filter), quick(quick_run), first_result(true), failures(0) {
+		samples.reserve(max_samples());
+	}
+
+	bool is_quick() const {
+		return quick;
+	}
+
+	unsigned long get_failures() const {
+		return failures;
+	}
+
+	bool is_selected(const char* name) const {
+		return !filter || std::strstr(name, filter);
+	}
+
+	/*
+		call()    .    , 
+		required == false,      .
+	*/
+	template <class Functor>
+	void run(const char* name, const char* params, Functor call, bool required = true) {
+		if (!is_selected(name)) return;
+
+		bool ok = call();
+		if (!ok && !required) {
+			begin_result(name, params);
+			std::fprintf(output, ", \"skipped\": true}");
+			return;
+		}
+
+		/*
+			    ,       
+		*/
+		boost::uint64_t warmup_begin = now();
+		unsigned long warmup_calls = 0;
+		while (warmup_calls < (quick ? 2ul : 16ul) && now() - warmup_begin < time_budget() / 10) {
+			ok &= call();
+			warmup_calls++;
+		}
+
+		boost::uint64_t single_begin = now();
+		ok &= call();
+		boost::uint64_t single_time = now() - single_begin;
+
+		unsigned long batch = single_time ? (unsigned long)(2000 / single_time) : 1000;
+		if (batch < 1) batch = 1;
+		if (batch > 1000) batch = 1000;
+
+		detail::HeapStatisticsStruct heap_before;
+		detail::HeapStatisticsStruct heap_after;
+		boost::perfomance::heap_counter heap;
+		bool heap_active = heap.get_current_thread_statistics(heap_before);
+
+		samples.clear();
+		unsigned long long calls = 0;
+		boost::uint64_t run_begin = now();
+
+		while (samples.size() < max_samples() && (samples.size() < 8 || now() - run_begin < time_budget())) {
+			boost::uint64_t begin = now();
+			for (unsigned long i = 0; i < batch; i++) ok &= call();
+			boost::uint64_t end = now();
+
+			samples.push_back((double)(end - begin) / batch);
+			calls += batch;
+		}
+
+		heap_active = heap_active && heap.get_current_thread_statistics(heap_after);
+
+		double sum = 0;
+		for (std::size_t i = 0; i < samples.size(); i++) sum += samples[i];
+		std::sort(samples.begin(), samples.end());
+
+		begin_result(name, params);
+		std::fprintf(output, ", \"calls\": %llu, \"batch\": %lu, \"mean_ns\": %.1f, \"min_ns\": %.1f, \"p50_ns\": %.1f, \"p99_ns\": %.1f",
+			calls, batch, sum / samples.size(), samples.front(), samples[(samples.size() - 1) / 2], samples[(samples.size() - 1) * 99 / 100]);
+
+		if (heap_active) {
+			std::fprintf(output, ", \"allocations_per_call\": %.3f, \"bytes_per_call\": %.1f",
+				(double)(heap_after.Allocations - heap_before.Allocations) / calls,
+				(double)(heap_after.AllocatedBytes - heap_before.AllocatedBytes) / calls);
+		}
+
+		std::fprintf(output, ", \"ok\": %s}", ok ? "true" : "false");
+		std::fflush(output);
+
+		if (!ok) {
+			std::fprintf(stderr, "perfomance_benchmark: %s {%s} failed\n", name, params);
+			failures++;
+		}
+	}
+};
+
+/*
+	 ,      . 
+	  stderr    .
+*/
+class value_checker {
+private:
+	unsigned long checks;
+	unsigned long failures;
+
+public:
+	value_checker() : checks(0), failures(0) {}
+
+	unsigned long get_checks() const {
+		return checks;
+	}
+
+	unsigned long get_failures() const {
+		return failures;
+	}
+
+	bool expect(const char* name, bool condition) {
+		checks++;
+		if (condition) return true;
+
+		std::fprintf(stderr, "perfomance_benchmark: %s failed\n", name);
+		failures++;
+		return false;
+	}
+
+	bool expect_between(const char* name, double value, double low, double high) {
+		checks++;
+		if (value >= low && value <= high) return true;
+
+		std::fprintf(stderr, "perfomance_benchmark: %s = %.9g, expected [%.9g, %.9g]\n", name, value, low, high);
+		failures++;
+		return false;
+	}
+
+	bool expect_near(const char* name, double value, double expected, double tolerance = 1e-6) {
+		return expect_between(name, value, expected - tolerance, expected + tolerance);
+	}
+};
+
+/*
+	    ,    
+*/
+class fixture_directory {
+private:
+	char path[64];
+	std::vector<std::string> files;
+	std::vector<std::string> directories;
+
+	fixture_directory(const fixture_directory&);
+	fixture_directory& operator=(const fixture_directory&);
+
+public:
+	fixture_directory() {
+		std::strcpy(path, "/tmp/perfomance_benchmark.XXXXXX");
+		if (!::mkdtemp(path)) path[0] = 0;
+	}
+
+	~fixture_directory() {
+		for (std::size_t i = 0; i < files.size(); i++) ::unlink(files[i].c_str());
+		for (std::size_t i = directories.size(); i > 0; i--) ::rmdir(directories[i - 1].c_str());
+		if (path[0]) ::rmdir(path);
+	}
+
+	bool is_open() const {
+		return path[0] != 0;
+	}
+
+	std::string file_path(const char* name) {
+		std::string file = std::string(path) + "/" + name;
+		if (std::find(files.begin(), files.end(), file) == files.end()) files.push_back(file);
+		return file;
+	}
+
+	/*
+		 ,     ,  
+	*/
+	std::string directory_path(const char* name) {
+		std::string directory = std::string(path) + "/" + name;
+		if (std::find(directories.begin(), directories.end(), directory) == directories.end()) {
+			::mkdir(directory.c_str(), 0755);
+			directories.push_back(directory);
+		}
+
+		return directory;
+	}
+
+	bool write_value(const std::string& file, unsigned long long value) {
+		FILE* stream = std::fopen(file.c_str(), "w");
+		if (!stream) return false;
+
+		std::fprintf(stream, "%llu\n", value);
+		std::fclose(stream);
+		return true;
+	}
+
+	/*
+		    inode,   
+		   
+	*/
+	bool write_data(const std::string& file, const void* data, std::size_t size) {
+		FILE* stream = std::fopen(file.c_str(), "w");
+		if (!stream) return false;
+
+		bool ok = std::fwrite(data, 1, size, stream) == size;
+		return std::fclose(stream) == 0 && ok;
+	}
+
+	bool write_text(const std::string& file, const char* text) {
+		return write_data(file, text, std::strlen(text));
+	}
+
+	/*
+		   /proc/stat    ,   intr  softirq,
+		    cpu     
+	*/
+	std::string write_proc_stat(unsigned long core_count) {
+		char name[32];
+		std::snprintf(name, sizeof(name), "stat.%lu", core_count);
+		std::string file = file_path(name);
+
+		FILE* stat = std::fopen(file.c_str(), "w");
+		if (!stat) return std::string();
+
+		std::fprintf(stat, "cpu  %lu 2906 %lu %lu 1668 0 2519 0 0 0\n", 101321ul * core_count, 30847ul * core_count, 468284ul * core_count);
+		for (unsigned long i = 0; i < core_count; i++) {
+			std::fprintf(stat, "cpu%lu %lu %lu %lu %lu %lu 0 %lu 0 0 0\n", i, 101321 + i * 7, 2906 + i, 30847 + i * 3, 468284 + i * 11, 1668 + i, 2519 + i);
+		}
+
+		std::fprintf(stat, "intr 81234567");
+		for (int i = 0; i < 512; i++) std::fprintf(stat, " %d", i & 7 ? 0 : i * 13);
+		std::fprintf(stat, "\nctxt 123456789\nbtime 1700000000\nprocesses 123456\nprocs_running 2\nprocs_blocked 0\n");
+		std::fprintf(stat, "softirq 4567890 12 345678 9 45678 9012 0 34 456789 0 123456\n");
+		std::fclose(stat);
+		return file;
+	}
+
+	/*
+		   /proc/schedstat ( 15)       
+	*/
+	std::string write_schedstat(unsigned long core_count) {
+		char name[32];
+		std::snprintf(name, sizeof(name), "schedstat.%lu", core_count);
+		std::string file = file_path(name);
+
+		FILE* schedstat = std::fopen(file.c_str(), "w");
+		if (!schedstat) return std::string();
+
+		std::fprintf(schedstat, "version 15\ntimestamp 4302227089\n");
+		for (unsigned long i = 0; i < core_count; i++) {
+			std::fprintf(schedstat, "cpu%lu 0 0 %lu %lu %lu %lu %lu %lu %lu\n", i, 981234 + i, 412345 + i, 562345 + i, 212345 + i,
+				91234567890ul + i * 1000, 1234567890ul + i * 100, 771234 + i);
+			for (int domain = 0; domain < 2; domain++) {
+				std::fprintf(schedstat, "domain%d %016lx", domain, (1ul << (i % 64)) | 1);
+				for (int field = 0; field < 45; field++) std::fprintf(schedstat, " %d", field * 7 % 13);
+				std::fprintf(schedstat, "\n");
+			}
+		}
+
+		std::fclose(schedstat);
+		return file;
+	}
+
+	/*
+		   /proc/diskstats (17 )    ,
+		     
+	*/
+	std::string write_diskstats(unsigned long device_count) {
+		char name[32];
+		std::snprintf(name, sizeof(name), "diskstats.%lu", device_count);
+		std::string file = file_path(name);
+
+		FILE* diskstats = std::fopen(file.c_str(), "w");
+		if (!diskstats) return std::string();
+
+		for (unsigned long i = 0; i < device_count; i++) {
+			unsigned long disk = i / 4;
+			unsigned long partition = i % 4;
+			std::fprintf(diskstats, "%4lu %7lu nvme%lun1%s", 259ul, disk * 4 + partition, disk, partition ? "p" : "");
+			if (partition) std::fprintf(diskstats, "%lu", partition);
+			std::fprintf(diskstats, " %lu 1234 %lu 56789 %lu 2345 %lu 67890 0 123456 234567 0 0 0 0 %lu 4567\n",
+				812345 + i, 23456789 + i * 8, 412345 + i, 34567890 + i * 8, 34567 + i);
+		}
+
+		std::fclose(diskstats);
+		return file;
+	}
+
+	/*
+		 cpu<N>   /sys/devices/system/cpu (cpufreq, thermal_throttle 
+		  cpuidle)  <N>/msr   /dev/cpu.     
+		 0xE7  0xE8  (  8  ),  msr
+		        .
+	*/
+	bool write_cpu_sysfs(unsigned long core_count, std::string& cpu_directory, std::string& msr_directory) {
+		static const char* const idle_names[] = { "POLL", "C1", "C1E", "C3", "C6", "C10" };
+		static const std::size_t idle_state_count = sizeof(idle_names) / sizeof(idle_names[0]);
+		char name[128];
+
+		std::snprintf(name, sizeof(name), "cpu.%lu", core_count);
+		cpu_directory = directory_path(name);
+		std::snprintf(name, sizeof(name), "msr.%lu", core_count);
+		msr_directory = directory_path(name);
+
+		for (unsigned long i = 0; i < core_count; i++) {
+			char core[64];
+			std::snprintf(core, sizeof(core), "cpu.%lu/cpu%lu", core_count, i);
+			std::string core_name = core;
+
+			directory_path(core);
+			directory_path((core_name + "/cpufreq").c_str());
+			directory_path((core_name + "/thermal_throttle").c_str());
+			directory_path((core_name + "/cpuidle").c_str());
+
+			bool ok = write_value(file_path((core_name + "/cpufreq/cpuinfo_max_freq").c_str()), 3800000)
+				&& write_value(file_path((core_name + "/cpufreq/base_frequency").c_str()), 2100000)
+				&& write_value(file_path((core_name + "/cpufreq/scaling_cur_freq").c_str()), 2400000 + i * 1000)
+				&& write_value(file_path((core_name + "/thermal_throttle/core_throttle_count").c_str()), 12 + i)
+				&& write_value(file_path((core_name + "/thermal_throttle/package_throttle_count").c_str()), 345)
+				&& write_value(file_path((core_name + "/thermal_throttle/core_throttle_total_time_ms").c_str()), 6789 + i);
+			if (!ok) return false;
+
+			for (std::size_t state = 0; state < idle_state_count; state++) {
+				std::snprintf(name, sizeof(name), "%s/cpuidle/state%zu", core, state);
+				std::string state_name = name;
+				directory_path(name);
+				if (!write_value(file_path((state_name + "/time").c_str()), 123456789ull * (state + 1) + i)) return false;
+
+				FILE* name_file = std::fopen(file_path((state_name + "/name").c_str()).c_str(), "w");
+				if (!name_file) return false;
+				std::fprintf(name_file, "%s\n", idle_names[state]);
+				std::fclose(name_file);
+			}
+
+			std::snprintf(name, sizeof(name), "msr.%lu/%lu", core_count, i);
+			directory_path(name);
+			std::snprintf(name, sizeof(name), "msr.%lu/%lu/msr", core_count, i);
+			FILE* msr = std::fopen(file_path(name).c_str(), "w");
+			if (!msr) return false;
+
+			unsigned char registers[0xF0];
+			for (std::size_t byte = 0; byte < sizeof(registers); byte++) registers[byte] = (unsigned char)(byte * 7 + i);
+			std::fwrite(registers, 1, sizeof(registers), msr);
+			std::fclose(msr);
+		}
+
+		return true;
+	}
+
+	/*
+		 cpu, memory  io   /proc/pressure   
+	*/
+	const char* write_pressure() {
+		static const char* const names[] = { "cpu", "memory", "io" };
+		for (int i = 0; i < 3; i++) {
+			FILE* pressure = std::fopen(file_path(names[i]).c_str(), "w");
+			if (!pressure) return NULL;
+
+			std::fprintf(pressure, "some avg10=1.55 avg60=0.92 avg300=0.53 total=39337728\nfull avg10=0.00 avg60=0.00 avg300=0.00 total=1735084\n");
+			std::fclose(pressure);
+		}
+
+		return path;
+	}
+};
+
+/*
+	 ,    
+*/
+class child_processes {
+private:
+	std::vector<int> process_ids;
+
+	child_processes(const child_processes&);
+	child_processes& operator=(const child_processes&);
+
+public:
+	child_processes() {}
+
+	~child_processes() {
+		resize(0);
+	}
+
+	bool resize(std::size_t count) {
+		while (process_ids.size() > count) {
+			::kill(process_ids.back(), SIGKILL);
+			::waitpid(process_ids.back(), NULL, 0);
+			process_ids.pop_back();
+		}
+
+		while (process_ids.size() < count) {
+			pid_t pid = ::fork();
+			if (pid < 0) return false;
+			if (pid == 0) {
+				for (;;) ::pause();
+			}
+			process_ids.push_back(pid);
+		}
+
+		return true;
+	}
+
+	const int* data() const {
+		return process_ids.data();
+	}
+
+	std::size_t size() const {
+		return process_ids.size();
+	}
+};
+
+/*
+	 TCP   loopback,     
+*/
+class loopback_connections {
+private:
+	int listener;
+	sockaddr_in address;
+	std::vector<int> sockets;
+
+	loopback_connections(const loopback_connections&);
+	loopback_connections& operator=(const loopback_connections&);
+
+public:
+	loopback_connections() : listener(-1) {
+		std::memset(&address, 0, sizeof(address));
+		address.sin_family = AF_INET;
+		address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+		listener = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+		socklen_t address_size = sizeof(address);
+		if (listener >= 0 && (::bind(listener, (sockaddr*)&address, sizeof(address)) || ::listen(listener, 4096) ||
+			::getsockname(listener, (sockaddr*)&address, &address_size))) {
+			::close(listener);
+			listener = -1;
+		}
+	}
+
+	~loopback_connections() {
+		resize(0);
+		if (listener >= 0) ::close(listener);
+	}
+
+	bool resize(std::size_t count) {
+		while (sockets.size() > count * 2) {
+			::close(sockets.back());
+			sockets.pop_back();
+		}
+
+		while (sockets.size() < count * 2) {
+			if (listener < 0) return false;
+
+			int client = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+			if (client < 0) return false;
+			if (::connect(client, (sockaddr*)&address, sizeof(address))) {
+				::close(client);
+				return false;
+			}
+
+			int server = ::accept4(listener, NULL, NULL, SOCK_CLOEXEC);
+			if (server < 0) {
+				::close(client);
+				return false;
+			}
+
+			sockets.push_back(client);
+			sockets.push_back(server);
+		}
+
+		return true;
+	}
+};
+
+/*
+	     (, )
+*/
+template <class Functor>
+bool wait_for(Functor ready) {
+	for (int i = 0; i < 200; i++) {
+		if (ready()) return true;
+		::usleep(5000);
+	}
+	return false;
+}
+
+/*
+	,      
+*/
+class idle_threads {
+private:
+	int pipe_fds[2];
+	boost::container::vector<boost::thread*> threads;
+
+	idle_threads(const idle_threads&);
+	idle_threads& operator=(const idle_threads&);
+
+	static void wait_proc(int fd) {
+		char symbol = 0;
+		while (::read(fd, &symbol, 1) < 0 && errno == EINTR) {}
+	}
+
+public:
+	idle_threads() {
+		if (::pipe(pipe_fds)) pipe_fds[0] = pipe_fds[1] = -1;
+	}
+
+	~idle_threads() {
+		if (pipe_fds[1] >= 0) ::close(pipe_fds[1]);
+		for (std::size_t i = 0; i < threads.size(); i++) {
+			threads[i]->join();
+			delete threads[i];
+		}
+		if (pipe_fds[0] >= 0) ::close(pipe_fds[0]);
+	}
+
+	bool grow(std::size_t count) {
+		if (pipe_fds[0] < 0) return false;
+		while (threads.size() < count) threads.push_back(new boost::thread(&idle_threads::wait_proc, pipe_fds[0]));
+		return true;
+	}
+};
+
+void raise_descriptor_limit() {
+	rlimit limit;
+	if (!::getrlimit(RLIMIT_NOFILE, &limit) && limit.rlim_cur < limit.rlim_max) {
+		limit.rlim_cur = limit.rlim_max;
+		::setrlimit(RLIMIT_NOFILE, &limit);
+	}
+}
+
+void run_cpu_benchmarks(benchmark_runner& runner, fixture_directory& fixtures) {
+	boost::container::vector<float> core_load;
+	float base_load = 0.f;
+
+	{
+		linux_::cpu_counter counter;
+		char params[96];
+		std::snprintf(params, sizeof(params), "\"source\": \"/proc/stat\", \"cores\": %lu", counter.get_cpu_count());
+
+		runner.run("cpu_counter.get_load", params, [&] { return counter.get_load(base_load); });
+		runner.run("cpu_counter.get_load_per_core", params, [&] { return counter.get_load_per_core(core_load, base_load); });
+	}
+
+	if (!fixtures.is_open()) return;
+
+	static const unsigned long core_counts[] = { 1, 8, 64, 256, 1024 };
+	for (std::size_t i = 0; i < sizeof(core_counts) / sizeof(core_counts[0]); i++) {
+		std::string stat_path = fixtures.write_proc_stat(core_counts[i]);
+		linux_::cpu_counter counter(stat_path.c_str(), core_counts[i]);
+
+		char params[96];
+		std::snprintf(params, sizeof(params), "\"source\": \"fixture\", \"cores\": %lu", core_counts[i]);
+
+		runner.run("cpu_counter.get_load", params, [&] { return counter.get_load(base_load); });
+		runner.run("cpu_counter.get_load_per_core", params, [&] { return counter.get_load_per_core(core_load, base_load); });
+	}
+}
+
+void run_kernel_benchmarks(benchmark_runner& runner) {
+	typedef struct {
+		const char* Name;
+		detail::core_load_kernel Kernel;
+		bool Supported;
+	} KernelStruct;
+
+	KernelStruct kernels[] = {
+		{ "scalar", &detail::load_kernels::scalar, true },
+#ifdef BOOST_PERFOMANCE_HAS_LOAD_KERNELS
+		{ "avx2", &detail::load_kernels::avx2, detail::load_kernels::cpu_supports(false) },
+		{ "avx512", &detail::load_kernels::avx512, detail::load_kernels::cpu_supports(true) },
+#endif
+	};
+
+	static const std::size_t core_counts[] = { 8, 64, 256, 1024 };
+	for (std::size_t i = 0; i < sizeof(core_counts) / sizeof(core_counts[0]); i++) {
+		std::size_t count = core_counts[i];
+		std::vector<boost::uint64_t> idle(count), total(count), prev_idle(count), prev_total(count);
+		std::vector<float> load(count);
+
+		for (std::size_t kernel = 0; kernel < sizeof(kernels) / sizeof(kernels[0]); kernel++) {
+			if (!kernels[kernel].Supported) continue;
+
+			char params[96];
+			std::snprintf(params, sizeof(params), "\"kernel\": \"%s\", \"cores\": %zu", kernels[kernel].Name, count);
+
+			/*
+				   ,      
+			*/
+			boost::uint64_t tick = 0;
+			detail::CoreLoadStateStruct state = { idle.data(), total.data(), prev_idle.data(), prev_total.data() };
+			runner.run("calculate_core_load", params, [&] {
+				tick++;
+				idle[tick % count] += 3;
+				total[tick % count] += 10;
+				return kernels[kernel].Kernel(state, load.data(), count) >= 0.f;
+			});
+		}
+	}
+}
+
+void run_memory_benchmarks(benchmark_runner& runner) {
+	linux_::memory_counter counter;
+	unsigned long long value = 0;
+
+	runner.run("memory_counter.get_swap_load", "", [&] { return counter.get_swap_load(value); });
+	runner.run("memory_counter.get_vmemory_load", "", [&] { return counter.get_vmemory_load(value); });
+	unsigned long long second_value = 0;
+	runner.run("memory_counter.get_system_memory_load", "", [&] { return counter.get_system_memory_load(value, second_value); });
+	runner.run("memory_counter.get_process_swap_load", "", [&] { return counter.get_process_swap_load(value); });
+	runner.run("memory_counter.get_process_vmemory_load", "", [&] { return counter.get_process_vmemory_load(value); });
+
+	int self = (int)::getpid();
+	runner.run("memory_counter.get_process_vmemory_load(pid)", "", [&] { return counter.get_process_vmemory_load(self, value); });
+	runner.run("memory_counter.get_process_swap_load(pid)", "", [&] { return counter.get_process_swap_load(self, value); });
+
+	if (!runner.is_selected("memory_counter.get_process_vmemory_load(pids)")) return;
+
+	child_processes children;
+	std::vector<unsigned long long> values;
+	static const std::size_t process_counts[] = { 1, 16, 128, 512 };
+
+	for (std::size_t i = 0; i < sizeof(process_counts) / sizeof(process_counts[0]); i++) {
+		std::size_t count = process_counts[i];
+		if (runner.is_quick() && count > 128) break;
+		if (!children.resize(count)) break;
+		values.resize(count);
+
+		char params[64];
+		std::snprintf(params, sizeof(params), "\"processes\": %zu", count);
+		runner.run("memory_counter.get_process_vmemory_load(pids)", params, [&] {
+			return counter.get_process_vmemory_load(children.data(), children.size(), values.data());
+		});
+	}
+}
+
+void run_process_benchmarks(benchmark_runner& runner) {
+	if (!runner.is_selected("process_scanner")) return;
+
+	child_processes children;
+	boost::container::vector<linux_::ProcessUsageStruct> top;
+	static const std::size_t process_counts[] = { 0, 128, 1024 };
+
+	for (std::size_t i = 0; i < sizeof(process_counts) / sizeof(process_counts[0]); i++) {
+		std::size_t count = process_counts[i];
+		if (runner.is_quick() && count > 128) break;
+		if (!children.resize(count)) break;
+
+		linux_::process_scanner scanner;
+		scanner.refresh();
+
+		char params[64];
+		std::snprintf(params, sizeof(params), "\"extra_processes\": %zu, \"processes\": %zu", count, scanner.get_process_count());
+
+		runner.run("process_scanner.refresh", params, [&] { return scanner.refresh(); });
+		runner.run("process_scanner.get_top", params, [&] { return scanner.get_top(linux_::eRankCpuLoad, 10, top); });
+	}
+}
+
+void run_thread_benchmarks(benchmark_runner& runner) {
+	if (!runner.is_selected("thread_counter")) return;
+
+	idle_threads threads;
+	static const std::size_t thread_counts[] = { 0, 16, 256 };
+
+	for (std::size_t i = 0; i < sizeof(thread_counts) / sizeof(thread_counts[0]); i++) {
+		std::size_t count = thread_counts[i];
+		if (!threads.grow(count)) break;
+
+		linux_::thread_counter counter;
+		counter.register_current_thread("benchmark");
+		counter.refresh();
+
+		char params[64];
+		std::snprintf(params, sizeof(params), "\"extra_threads\": %zu, \"threads\": %zu", count, counter.get_thread_count());
+		runner.run("thread_counter.refresh", params, [&] { return counter.refresh(); });
+	}
+}
+
+void run_sched_benchmarks(benchmark_runner& runner, fixture_directory& fixtures) {
+	boost::container::vector<linux_::CoreSchedulerStruct> core_latency;
+	linux_::PressureStruct pressure;
+
+	{
+		linux_::sched_counter counter;
+		runner.run("sched_counter.get_pressure", "\"source\": \"/proc/pressure\", \"resource\": \"cpu\"", [&] { return counter.get_pressure(linux_::ePressureCpu, pressure); }, false);
+
+		char params[96];
+		std::snprintf(params, sizeof(params), "\"source\": \"/proc/schedstat\", \"cores\": %lu", counter.get_cpu_count());
+		runner.run("sched_counter.get_core_latency", params, [&] { return counter.get_core_latency(core_latency); }, false);
+	}
+
+	if (!fixtures.is_open()) return;
+
+	const char* pressure_directory = fixtures.write_pressure();
+	static const unsigned long core_counts[] = { 8, 64, 256 };
+
+	for (std::size_t i = 0; i < sizeof(core_counts) / sizeof(core_counts[0]); i++) {
+		std::string schedstat_path = fixtures.write_schedstat(core_counts[i]);
+		linux_::sched_counter counter(schedstat_path.c_str(), pressure_directory ? pressure_directory : "", core_counts[i]);
+
+		char params[96];
+		std::snprintf(params, sizeof(params), "\"source\": \"fixture\", \"cores\": %lu", core_counts[i]);
+		runner.run("sched_counter.get_core_latency", params, [&] { return counter.get_core_latency(core_latency); });
+		if (i == 0) runner.run("sched_counter.get_pressure", "\"source\": \"fixture\", \"resource\": \"cpu\"", [&] { return counter.get_pressure(linux_::ePressureCpu, pressure); });
+	}
+}
+
+void run_cpufreq_benchmarks(benchmark_runner& runner, fixture_directory& fixtures) {
+	boost::container::vector<linux_::CoreFrequencyStruct> core_frequency;
+
+	{
+		linux_::cpufreq_counter counter;
+
+		char params[96];
+		std::snprintf(params, sizeof(params), "\"source\": \"/sys/devices/system/cpu\", \"cores\": %lu", counter.get_cpu_count());
+		runner.run("cpufreq_counter.get_core_frequency", params, [&] { return counter.get_core_frequency(core_frequency); }, false);
+	}
+
+	if (!fixtures.is_open() || !runner.is_selected("cpufreq_counter")) return;
+
+	static const unsigned long core_counts[] = { 8, 64, 256 };
+	for (std::size_t i = 0; i < sizeof(core_counts) / sizeof(core_counts[0]); i++) {
+		if (runner.is_quick() && core_counts[i] > 64) break;
+
+		std::string cpu_directory;
+		std::string msr_directory;
+		if (!fixtures.write_cpu_sysfs(core_counts[i], cpu_directory, msr_directory)) break;
+
+		linux_::cpufreq_counter counter(cpu_directory.c_str(), msr_directory.c_str(), core_counts[i]);
+
+		char params[96];
+		std::snprintf(params, sizeof(params), "\"source\": \"fixture\", \"cores\": %lu, \"idle_states\": %lu", core_counts[i], counter.get_idle_state_count());
+		runner.run("cpufreq_counter.get_core_frequency", params, [&] { return counter.get_core_frequency(core_frequency); });
+	}
+}
+
+void run_io_benchmarks(benchmark_runner& runner, fixture_directory& fixtures) {
+	boost::container::vector<linux_::DiskStatisticsStruct> statistics;
+	linux_::ProcessIoStruct process_io;
+
+	{
+		linux_::io_counter counter;
+		runner.run("io_counter.get_disk_statistics", "\"source\": \"/proc/diskstats\"", [&] { return counter.get_disk_statistics(statistics); });
+		runner.run("io_counter.get_process_io", "\"processes\": 1", [&] { return counter.get_process_io(0, process_io); }, false);
+
+		if (runner.is_selected("io_counter.get_process_io(pids)")) {
+			child_processes children;
+			std::vector<linux_::ProcessIoStruct> values;
+			static const std::size_t process_counts[] = { 16, 128 };
+
+			for (std::size_t i = 0; i < sizeof(process_counts) / sizeof(process_counts[0]); i++) {
+				std::size_t count = process_counts[i];
+				if (!children.resize(count)) break;
+				values.resize(count);
+
+				char params[64];
+				std::snprintf(params, sizeof(params), "\"processes\": %zu", count);
+				runner.run("io_counter.get_process_io(pids)", params, [&] {
+					return counter.get_process_io(children.data(), children.size(), values.data());
+				}, false);
+			}
+		}
+	}
+
+	if (!fixtures.is_open()) return;
+
+	static const unsigned long device_counts[] = { 4, 64, 512 };
+	for (std::size_t i = 0; i < sizeof(device_counts) / sizeof(device_counts[0]); i++) {
+		std::string diskstats_path = fixtures.write_diskstats(device_counts[i]);
+		linux_::io_counter counter(diskstats_path.c_str());
+
+		char params[96];
+		std::snprintf(params, sizeof(params), "\"source\": \"fixture\", \"devices\": %lu", device_counts[i]);
+		runner.run("io_counter.get_disk_statistics", params, [&] { return counter.get_disk_statistics(statistics); });
+	}
+}
+
+void run_network_benchmarks(benchmark_runner& runner) {
+	linux_::netword_counter counter;
+	linux_::tcp_socket_table table;
+	linux_::NetworkGlobalStatus global_status;
+
+	runner.run("netword_counter.get_global_network_info", "", [&] { return counter.get_global_network_info(global_status); }, false);
+
+	if (!runner.is_selected("netword_counter.get_tcp_table") && !runner.is_selected("netword_counter.resolve_processes")) return;
+
+	loopback_connections connections;
+	static const std::size_t connection_counts[] = { 0, 64, 512, 2048 };
+
+	for (std::size_t i = 0; i < sizeof(connection_counts) / sizeof(connection_counts[0]); i++) {
+		std::size_t count = connection_counts[i];
+		if (runner.is_quick() && count > 512) break;
+		if (!connections.resize(count)) break;
+
+		char params[64];
+		std::snprintf(params, sizeof(params), "\"connections\": %zu", count);
+
+		runner.run("netword_counter.get_tcp_table", params, [&] { return counter.get_tcp_table(table); }, false);
+		runner.run("netword_counter.resolve_processes", params, [&] { return counter.resolve_processes(table); }, false);
+	}
+}
+
+void run_system_benchmarks(benchmark_runner& runner) {
+	{
+		linux_::interface_counter counter;
+		boost::container::vector<linux_::InterfaceStatisticsStruct> statistics;
+		runner.run("interface_counter.get_interface_statistics", "", [&] { return counter.get_interface_statistics(statistics); }, false);
+	}
+
+	{
+		linux_::cgroup_counter counter;
+		linux_::CgroupCpuStruct cpu_statistics;
+		linux_::CgroupMemoryStruct memory_statistics;
+		double quota = 0;
+
+		if (counter.is_available()) {
+			runner.run("cgroup_counter.get_cpu_quota", "", [&] { return counter.get_cpu_quota(quota); }, false);
+			runner.run("cgroup_counter.get_cpu_statistics", "", [&] { return counter.get_cpu_statistics(cpu_statistics); }, false);
+			runner.run("cgroup_counter.get_memory_statistics", "", [&] { return counter.get_memory_statistics(memory_statistics); }, false);
+		} else {
+			runner.run("cgroup_counter.get_cpu_statistics", "", [&] { return false; }, false);
+		}
+	}
+
+	{
+		linux_::cpu_topology topology;
+		boost::container::vector<float> core_load(topology.get_cpu_count(), 0.5f);
+		boost::container::vector<float> domain_load;
+		runner.run("cpu_topology.aggregate_load", "\"level\": \"cache\"", [&] { return topology.aggregate_load(core_load, linux_::eTopologyCache, domain_load); }, false);
+	}
+
+	{
+		linux_::hw_counter counter(linux_::eThisThread);
+		linux_::HardwareCountersStruct counters;
+		runner.run("hw_counter.get_counters", "\"scope\": \"thread\"", [&] { return counter.is_open() && counter.get_counters(counters); }, false);
+	}
+}
+
+void run_library_benchmarks(benchmark_runner& runner, fixture_directory& fixtures) {
+	boost::perfomance::processor processor;
+
+	if (runner.is_selected("BOOST_PERFOMANCE_SCOPE")) {
+		processor.start_collector(boost::chrono::milliseconds(10));
+		runner.run("BOOST_PERFOMANCE_SCOPE", "", [] {
+			BOOST_PERFOMANCE_SCOPE("benchmark");
+			return true;
+		});
+		processor.stop_collector();
+	}
+
+	{
+		boost::perfomance::snapshot_result<boost::perfomance::metrics::cpu_load, boost::perfomance::metrics::system_memory, boost::perfomance::metrics::process_memory> result;
+		runner.run("processor.snapshot", "\"metrics\": \"cpu_load,system_memory,process_memory\"", [&] { return processor.snapshot(result); });
+	}
+
+	{
+		boost::perfomance::snapshot_result<boost::perfomance::metrics::cpu_load, boost::perfomance::metrics::network> result;
+		runner.run("processor.snapshot", "\"metrics\": \"cpu_load,network\"", [&] { return processor.snapshot(result); });
+	}
+
+	{
+		boost::perfomance::heap_counter heap;
+		detail::HeapStatisticsStruct statistics;
+		runner.run("heap_counter.get_current_thread_statistics", "", [&] { return heap.get_current_thread_statistics(statistics); });
+		runner.run("heap_counter.get_statistics", "", [&] { return heap.get_statistics(statistics); });
+	}
+
+	if (runner.is_selected("basic_cpu_sampler")) {
+		detail::basic_cpu_sampler<detail::platform::cpu_counter> sampler(boost::chrono::milliseconds(10));
+		boost::container::vector<float> core_load;
+		float base_load = 0.f;
+		wait_for([&] { return sampler.get_load(base_load); });
+		runner.run("basic_cpu_sampler.get_load", "", [&] { return sampler.get_load(base_load); });
+		runner.run("basic_cpu_sampler.get_load_per_core", "", [&] { return sampler.get_load_per_core(core_load); });
+	}
+
+	if (runner.is_selected("shared_subscriber")) {
+		char name[64];
+		std::snprintf(name, sizeof(name), "perfomance_benchmark.%d", (int)::getpid());
+
+		boost::perfomance::shared_publisher publisher(name, boost::chrono::milliseconds(10));
+		boost::perfomance::shared_subscriber subscriber(name);
+		float base_load = 0.f;
+		wait_for([&] { return subscriber.get_load(base_load); });
+		runner.run("shared_subscriber.get_load", "", [&] { return subscriber.get_load(base_load); });
+	}
+
+	if (fixtures.is_open() && runner.is_selected("recorder.append")) {
+		static const std::size_t channel_counts[] = { 1, 9, 65 };
+		for (std::size_t i = 0; i < sizeof(channel_counts) / sizeof(channel_counts[0]); i++) {
+			std::string path = fixtures.file_path("record");
+			::unlink(path.c_str());
+
+			boost::perfomance::recorder recorder;
+			if (!recorder.open(path.c_str(), channel_counts[i], 10.0, 24 * 3600.0)) continue;
+
+			std::vector<float> values(channel_counts[i], 0.25f);
+			boost::uint64_t timestamp = 1700000000000000000ull;
+
+			char params[64];
+			std::snprintf(params, sizeof(params), "\"channels\": %zu", channel_counts[i]);
+			runner.run("recorder.append", params, [&] {
+				timestamp += 100000000;
+				values[timestamp / 100000000 % values.size()] += 0.01f;
+				return recorder.append(timestamp, values.data());
+			});
+		}
+	}
+
+	if (runner.is_selected("openmetrics_exporter.render")) {
+		boost::asio::io_context io_context;
+		boost::perfomance::openmetrics_exporter exporter(io_context, 0);
+		runner.run("openmetrics_exporter.render", "", [&] { return exporter.render().size() != 0; });
+	}
+}
+
+boost::uint64_t steady_nanoseconds() {
+	timespec now;
+	::clock_gettime(CLOCK_MONOTONIC, &now);
+	return (boost::uint64_t)now.tv_sec * 1000000000ull + (boost::uint64_t)now.tv_nsec;
+}
+
+/*
+	     ,    
+	:           
+	         
+*/
+typedef struct {
+	boost::uint64_t Begin;
+	boost::uint64_t End;
+} CallTimeStruct;
+
+template <class Functor>
+bool timed_call(CallTimeStruct& time, Functor call) {
+	time.Begin = steady_nanoseconds();
+	bool ret_value = call();
+	time.End = steady_nanoseconds();
+	return ret_value;
+}
+
+void expect_rate(value_checker& checker, const char* name, double value, double delta, const CallTimeStruct& first, const CallTimeStruct& second, double unit) {
+	double longest = (double)(second.End - first.Begin) * unit;
+	double shortest = (double)(second.Begin - first.End) * unit;
+	checker.expect_between(name, value, delta / longest * 0.999, shortest > 0 ? delta / shortest * 1.001 : 1e300);
+}
+
+/*
+	    "cpu"      ,   
+	 iowait  (    total)
+*/
+void verify_cpu_counter(value_checker& checker, fixture_directory& fixtures) {
+	std::string stat_path = fixtures.file_path("stat.verify");
+	if (!checker.expect("cpu_counter: write fixture", fixtures.write_text(stat_path,
+		"cpu  200 0 100 700 20 0 0 0 0 0\ncpu0 100 0 50 350 20 0 0 0 0 0\ncpu1 100 0 50 350 0 0 0 0 0 0\n"))) return;
+
+	linux_::cpu_counter base_counter(stat_path.c_str(), 2);
+	linux_::cpu_counter core_counter(stat_path.c_str(), 2);
+	boost::container::vector<float> core_load;
+	float base_load = -1.f;
+	float core_base_load = -1.f;
+
+	fixtures.write_text(stat_path, "cpu  270 0 100 830 20 0 0 0 0 0\ncpu0 160 0 50 390 20 0 0 0 0 0\ncpu1 110 0 50 440 0 0 0 0 0 0\n");
+	checker.expect("cpu_counter.get_load", base_counter.get_load(base_load));
+	checker.expect("cpu_counter.get_load_per_core", core_counter.get_load_per_core(core_load, core_base_load) && core_load.size() == 2);
+	checker.expect_near("cpu_counter.get_load", base_load, 0.35);
+	checker.expect_near("cpu_counter.get_load_per_core base", core_base_load, 0.35);
+	if (core_load.size() == 2) {
+		checker.expect_near("cpu_counter.get_load_per_core cpu0", core_load[0], 0.6);
+		checker.expect_near("cpu_counter.get_load_per_core cpu1", core_load[1], 0.1);
+	}
+
+	fixtures.write_text(stat_path, "cpu  280 0 100 830 15 0 0 0 0 0\ncpu0 170 0 50 390 15 0 0 0 0 0\ncpu1 110 0 50 440 0 0 0 0 0 0\n");
+	checker.expect("cpu_counter.get_load (iowait decreased)", base_counter.get_load(base_load));
+	checker.expect("cpu_counter.get_load_per_core (iowait decreased)", core_counter.get_load_per_core(core_load, core_base_load) && core_load.size() == 2);
+	checker.expect_near("cpu_counter.get_load (iowait decreased)", base_load, 0.0);
+	checker.expect_near("cpu_counter.get_load_per_core base (iowait decreased)", core_base_load, base_load);
+}
+
+void verify_sched_counter(value_checker& checker, fixture_directory& fixtures) {
+	std::string schedstat_path = fixtures.file_path("schedstat.verify");
+	std::string pressure_directory = fixtures.directory_path("pressure.verify");
+	std::string pressure_path = fixtures.file_path("pressure.verify/cpu");
+
+	bool ok = fixtures.write_text(schedstat_path, "version 15\ntimestamp 4302227089\ncpu0 0 0 0 0 0 0 1000000 500000 100\n")
+		&& fixtures.write_text(pressure_path, "some avg10=1.55 avg60=0.92 avg300=0.53 total=1000\nfull avg10=0.25 avg60=0.00 avg300=0.00 total=100\n");
+	if (!checker.expect("sched_counter: write fixture", ok)) return;
+
+	linux_::sched_counter counter(schedstat_path.c_str(), pressure_directory.c_str(), 1);
+	boost::container::vector<linux_::CoreSchedulerStruct> core_latency;
+	linux_::PressureStruct pressure;
+
+	checker.expect("sched_counter.get_pressure", counter.get_pressure(linux_::ePressureCpu, pressure));
+	checker.expect_near("sched_counter.get_pressure Some10", pressure.Some10, 1.55);
+	checker.expect_near("sched_counter.get_pressure Full10", pressure.Full10, 0.25);
+
+	fixtures.write_text(schedstat_path, "version 15\ntimestamp 4302227189\ncpu0 0 0 0 0 0 0 3000000 800000 160\n");
+	fixtures.write_text(pressure_path, "some avg10=1.55 avg60=0.92 avg300=0.53 total=1750\nfull avg10=0.25 avg60=0.00 avg300=0.00 total=130\n");
+
+	checker.expect("sched_counter.get_core_latency", counter.get_core_latency(core_latency) && core_latency.size() == 1);
+	if (core_latency.size() == 1) {
+		checker.expect_near("sched_counter.get_core_latency RunTime", (double)core_latency[0].RunTime, 2000000);
+		checker.expect_near("sched_counter.get_core_latency RunDelay", (double)core_latency[0].RunDelay, 300000);
+		checker.expect_near("sched_counter.get_core_latency AverageDelay", core_latency[0].AverageDelay, 5000);
+	}
+
+	checker.expect("sched_counter.get_pressure", counter.get_pressure(linux_::ePressureCpu, pressure));
+	checker.expect_near("sched_counter.get_pressure SomeStallMicroseconds", (double)pressure.SomeStallMicroseconds, 750);
+	checker.expect_near("sched_counter.get_pressure FullStallMicroseconds", (double)pressure.FullStallMicroseconds, 30);
+}
+
+void verify_io_counter(value_checker& checker, fixture_directory& fixtures) {
+	std::string diskstats_path = fixtures.file_path("diskstats.verify");
+	if (!checker.expect("io_counter: write fixture", fixtures.write_text(diskstats_path,
+		"   8       0 sda 100 0 800 50 200 0 1600 400 0 100 450 0 0 0 0 10 20\n"))) return;
+
+	linux_::io_counter counter(diskstats_path.c_str());
+	boost::container::vector<linux_::DiskStatisticsStruct> statistics;
+	CallTimeStruct first;
+	CallTimeStruct second;
+
+	checker.expect("io_counter.get_disk_statistics", timed_call(first, [&] { return counter.get_disk_statistics(statistics); }));
+	::usleep(20000);
+
+	fixtures.write_text(diskstats_path, "   8       0 sda 150 0 1200 150 210 0 1680 430 2 140 530 0 0 0 0 14 40\n");
+	checker.expect("io_counter.get_disk_statistics", timed_call(second, [&] { return counter.get_disk_statistics(statistics); }) && statistics.size() == 1);
+	if (statistics.size() != 1) return;
+
+	const linux_::DiskStatisticsStruct& device = statistics[0];
+	checker.expect("io_counter.get_disk_statistics Name", !std::strcmp(device.Name, "sda") && device.Major == 8 && device.Minor == 0);
+	expect_rate(checker, "io_counter.get_disk_statistics ReadsPerSecond", device.ReadsPerSecond, 50, first, second, 1e-9);
+	expect_rate(checker, "io_counter.get_disk_statistics WritesPerSecond", device.WritesPerSecond, 10, first, second, 1e-9);
+	checker.expect_near("io_counter.get_disk_statistics bytes per read", device.ReadsPerSecond > 0 ? device.ReadBytesPerSecond / device.ReadsPerSecond : 0, 4096);
+	checker.expect_near("io_counter.get_disk_statistics bytes per write", device.WritesPerSecond > 0 ? device.WriteBytesPerSecond / device.WritesPerSecond : 0, 4096);
+	checker.expect_near("io_counter.get_disk_statistics ReadLatency", device.ReadLatency, 2.0);
+	checker.expect_near("io_counter.get_disk_statistics WriteLatency", device.WriteLatency, 3.0);
+	checker.expect_near("io_counter.get_disk_statistics FlushLatency", device.FlushLatency, 5.0);
+	checker.expect_near("io_counter.get_disk_statistics InFlight", (double)device.InFlight, 2);
+}
+
+/*
+	MPERF (0xE7)  APERF (0xE8)    :    0xE7 
+	APERF = X  MPERF  X * 256,       / 256
+*/
+void verify_cpufreq_counter(value_checker& checker, fixture_directory& fixtures) {
+	std::string cpu_directory;
+	std::string msr_directory;
+	if (!checker.expect("cpufreq_counter: write fixture", fixtures.write_cpu_sysfs(1, cpu_directory, msr_directory))) return;
+
+	std::string msr_path = fixtures.file_path("msr.1/0/msr");
+	unsigned char registers[0xF0] = {};
+	fixtures.write_data(msr_path, registers, sizeof(registers));
+
+	CallTimeStruct first;
+	CallTimeStruct second;
+	first.Begin = steady_nanoseconds();
+	linux_::cpufreq_counter counter(cpu_directory.c_str(), msr_directory.c_str(), 1);
+	first.End = steady_nanoseconds();
+	::usleep(20000);
+
+	boost::uint64_t aperf = 1000000;
+	for (int i = 0; i < 8; i++) registers[0xE8 + i] = (unsigned char)(aperf >> (i * 8));
+	fixtures.write_data(msr_path, registers, sizeof(registers));
+	fixtures.write_value(fixtures.file_path("cpu.1/cpu0/thermal_throttle/core_throttle_count"), 15);
+	fixtures.write_value(fixtures.file_path("cpu.1/cpu0/cpuidle/state1/time"), 123456789ull * 2 + 10000);
+
+	boost::container::vector<linux_::CoreFrequencyStruct> core_frequency;
+	checker.expect("cpufreq_counter.get_core_frequency", timed_call(second, [&] { return counter.get_core_frequency(core_frequency); }) && core_frequency.size() == 1);
+	if (core_frequency.size() != 1) return;
+
+	const linux_::CoreFrequencyStruct& core = core_frequency[0];
+	checker.expect_near("cpufreq_counter.get_core_frequency BaseFrequency", (double)core.BaseFrequency, 2100000);
+	checker.expect_near("cpufreq_counter.get_core_frequency CurrentFrequency", (double)core.CurrentFrequency, 2400000);
+	checker.expect_near("cpufreq_counter.get_core_frequency EffectiveFrequency", (double)core.EffectiveFrequency, 8203);
+	checker.expect_near("cpufreq_counter.get_core_frequency ThrottleEvents", (double)core.ThrottleEvents, 3);
+	checker.expect_near("cpufreq_counter.get_core_frequency PackageThrottleEvents", (double)core.PackageThrottleEvents, 0);
+	if (checker.expect("cpufreq_counter.get_core_frequency IdleStateCount", core.IdleStateCount == 6)) {
+		checker.expect_near("cpufreq_counter.get_core_frequency IdleResidency[0]", core.IdleResidency[0], 0.0);
+		expect_rate(checker, "cpufreq_counter.get_core_frequency IdleResidency[1]", core.IdleResidency[1], 10000, first, second, 1e-3);
+	}
+}
+
+/*
+	,  recorder,        
+	      .   
+	   .
+*/
+void verify_recorder(value_checker& checker, fixture_directory& fixtures) {
+	static const std::size_t channel_count = 3;
+	static const std::size_t sample_count = 200;
+	static const double quantum = 0.001;
+	std::string path = fixtures.file_path("record.verify");
+	::unlink(path.c_str());
+
+	boost::uint64_t first_timestamp = 1700000000000000000ull;
+	{
+		boost::perfomance::recorder recorder;
+		if (!checker.expect("recorder.open", recorder.open_blocks(path.c_str(), channel_count, quantum, 16, 256))) return;
+
+		bool appended = true;
+		for (std::size_t i = 0; i < sample_count && appended; i++) {
+			float values[channel_count];
+			for (std::size_t channel = 0; channel < channel_count; channel++) values[channel] = (float)((i * 37 + channel * 11) % 1000) / 997.f;
+			appended = recorder.append(first_timestamp + i * 100000000ull, values);
+		}
+
+		if (!checker.expect("recorder.append", appended)) return;
+	}
+
+	boost::perfomance::record_reader reader;
+	if (!checker.expect("record_reader.open", reader.open(path.c_str()))) return;
+
+	std::size_t read_count = 0;
+	boost::uint64_t timestamp = 0;
+	float values[channel_count];
+	bool timestamps_match = true;
+	double max_error = 0;
+
+	while (reader.next(timestamp, values)) {
+		timestamps_match = timestamps_match && timestamp == first_timestamp + read_count * 100000000ull;
+		for (std::size_t channel = 0; channel < channel_count; channel++) {
+			double expected = (float)((read_count * 37 + channel * 11) % 1000) / 997.f;
+			double error = values[channel] > expected ? values[channel] - expected : expected - values[channel];
+			if (error > max_error) max_error = error;
+		}
+
+		read_count++;
+	}
+
+	checker.expect_near("record_reader.next count", (double)read_count, (double)sample_count);
+	checker.expect("record_reader.next timestamps", timestamps_match);
+	checker.expect_between("record_reader.next error", max_error, 0, quantum / 2 + 1e-6);
+}
+
+/*
+	,    ,      
+	  retention_seconds     ,  
+	     0  1
+*/
+void verify_recorder_retention(value_checker& checker, fixture_directory& fixtures) {
+	static const std::size_t channel_count = 9;
+	static const double sample_rate = 10.0;
+	static const double retention_seconds = 600.0;
+	static const std::size_t sample_count = 3 * 6000;
+	std::string path = fixtures.file_path("retention.verify");
+	::unlink(path.c_str());
+
+	boost::uint64_t first_timestamp = 1700000000000000000ull;
+	{
+		boost::perfomance::recorder recorder;
+		if (!checker.expect("recorder.open retention", recorder.open(path.c_str(), channel_count, sample_rate, retention_seconds))) return;
+
+		bool appended = true;
+		for (std::size_t i = 0; i < sample_count && appended; i++) {
+			float values[channel_count];
+			for (std::size_t channel = 0; channel < channel_count; channel++) values[channel] = (float)((i + channel) % 2);
+			appended = recorder.append(first_timestamp + i * 100000000ull, values);
+		}
+
+		if (!checker.expect("recorder.append retention", appended)) return;
+	}
+
+	boost::perfomance::record_reader reader;
+	if (!checker.expect("record_reader.open retention", reader.open(path.c_str()))) return;
+
+	std::size_t read_count = 0;
+	boost::uint64_t timestamp = 0;
+	boost::uint64_t last_timestamp = 0;
+	float values[channel_count];
+	while (reader.next(timestamp, values)) {
+		last_timestamp = timestamp;
+		read_count++;
+	}
+
+	checker.expect_between("record_reader.next retained seconds", (double)read_count / sample_rate, retention_seconds, 2 * retention_seconds);
+	checker.expect("record_reader.next last timestamp", last_timestamp == first_timestamp + (sample_count - 1) * 100000000ull);
+}
+
+int run_verify() {
+	fixture_directory fixtures;
+	if (!fixtures.is_open()) {
+		std::fprintf(stderr, "perfomance_benchmark: can't create fixture directory\n");
+		return 1;
+	}
+
+	value_checker checker;
+	verify_cpu_counter(checker, fixtures);
+	verify_sched_counter(checker, fixtures);
+	verify_io_counter(checker, fixtures);
+	verify_cpufreq_counter(checker, fixtures);
+	verify_recorder(checker, fixtures);
+	verify_recorder_retention(checker, fixtures);
+
+	std::fprintf(stderr, "perfomance_benchmark: %lu checks, %lu failed\n", checker.get_checks(), checker.get_failures());
+	return checker.get_failures() ? 1 : 0;
+}
+
+void print_usage() {
+	std::fprintf(stderr, "usage: perfomance_benchmark [--quick] [--filter <substring>] [--output <file>]\n");
+	std::fprintf(stderr, "       perfomance_benchmark --verify\n");
+}
+
+}
+
+int main(int argc, char** argv) {
+	bool quick = false;
+	const char* filter = NULL;
+	const char* output_path = NULL;
+
+	for (int i = 1; i < argc; i++) {
+		if (!std::strcmp(argv[i], "--verify") && argc == 2) {
+			return run_verify();
+		} else if (!std::strcmp(argv[i], "--quick")) {
+			quick = true;
+		} else if (!std::strcmp(argv[i], "--filter") && i + 1 < argc) {
+			filter = argv[++i];
+		} else if (!std::strcmp(argv[i], "--output") && i + 1 < argc) {
+			output_path = argv[++i];
+		} else {
+			print_usage();
+			return 2;
+		}
+	}
+
+	FILE* output = output_path ? std::fopen(output_path, "w") : stdout;
+	if (!output) {
+		std::fprintf(stderr, "perfomance_benchmark: can't open %s\n", output_path);
+		return 1;
+	}
+
+	raise_descriptor_limit();
+
+	long cpu_count = ::sysconf(_SC_NPROCESSORS_ONLN);
+	std::fprintf(output, "{\n\t\"benchmark\": \"boost.perfomance\",\n\t\"quick\": %s,\n\t\"cpu_count\": %ld,\n\t\"heap_counter\": %s,\n\t\"results\": [",
+		quick ? "true" : "false", cpu_count, boost::perfomance::heap_counter().is_active() ? "true" : "false");
+
+	unsigned long failures = 0;
+	{
+		benchmark_runner runner(output, filter, quick);
+		fixture_directory fixtures;
+
+		run_cpu_benchmarks(runner, fixtures);
+		run_kernel_benchmarks(runner);
+		run_memory_benchmarks(runner);
+		run_process_benchmarks(runner);
+		run_thread_benchmarks(runner);
+		run_sched_benchmarks(runner, fixtures);
+		run_io_benchmarks(runner, fixtures);
+		run_cpufreq_benchmarks(runner, fixtures);
+		run_network_benchmarks(runner);
+		run_system_benchmarks(runner);
+		run_library_benchmarks(runner, fixtures);
+		failures = runner.get_failures();
+	}
+
+	std::fprintf(output, "\n\t]\n}\n");
+	if (output != stdout) std::fclose(output);
+
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,482 @@
+#ifndef BOOST_PERFOMANCE_HEAP_COUNTER_HPP
+#define BOOST_PERFOMANCE_HEAP_COUNTER_HPP
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <new>
+#include <boost/config.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/atomic.hpp>
+#include <boost/container/vector.hpp>
+
+#if defined(__linux__)
+#include <malloc.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#elif defined(BOOST_WINDOWS)
+#include <malloc.h>
+#include <boost/winapi/thread.hpp>
+#endif
+
+namespace boost { namespace perfomance { namespace detail {
+
+enum {
+	heap_size_class_count = 16			// <=16, <=32, ..., <=256K,  256K
+};
+
+typedef struct {
+	unsigned long long Allocations;
+	unsigned long long Frees;
+	unsigned long long AllocatedBytes;		//     
+	unsigned long long FreedBytes;
+	unsigned long long SizeClasses[heap_size_class_count];	//    
+} HeapStatisticsStruct;
+
+typedef struct {
+	unsigned long ThreadId;				// gettid  Linux, GetCurrentThreadId  Windows
+	HeapStatisticsStruct Statistics;
+} HeapThreadStatisticsStruct;
+
+/*
+	  .       (load + store 
+	 ),      ,   
+	    .
+*/
+struct heap_thread_block {
+	enum {
+		allocations = 0,
+		frees,
+		allocated_bytes,
+		freed_bytes,
+		size_classes,
+		counter_count = size_classes + heap_size_class_count
+	};
+
+	BOOST_ALIGNMENT(64) boost::atomic<boost::uint64_t> counters[counter_count];
+	heap_thread_block* next;
+	boost::atomic<bool> in_use;
+	unsigned long thread_id;
+
+	void add(std::size_t index, boost::uint64_t value) {
+		counters[index].store(counters[index].load(boost::memory_order_relaxed) + value, boost::memory_order_relaxed);
+	}
+};
+
+inline std::size_t heap_size_class(std::size_t size) {
+	std::size_t size_class = 0;
+	for (std::size_t limit = 16; size > limit && size_class < heap_size_class_count - 1; limit <<= 1) {
+		size_class++;
+	}
+
+	return size_class;
+}
+
+/*
+	   .    posix_memalign,  
+	     operator new (   malloc 
+	    , . eThreadRegistering),    : 
+	          
+	 .    ,      main
+	 .
+*/
+class heap_registry {
+public:
+	enum EThreadState {
+		eThreadNone = 0,
+		eThreadRegistering,
+		eThreadActive,
+		eThreadExited
+	};
+
+private:
+	boost::atomic<heap_thread_block*> head;
+	boost::atomic<bool> lock_flag;
+	boost::atomic<bool> has_records;
+	boost::atomic<boost::uint64_t> retired[heap_thread_block::counter_count];
+
+	struct thread_exit_guard {
+		~thread_exit_guard() {
+			heap_registry::instance().release_thread();
+		}
+	};
+
+	heap_registry(const heap_registry&);
+	heap_registry& operator=(const heap_registry&);
+
+	heap_registry() : head(NULL), lock_flag(false), has_records(false) {
+		for (std::size_t i = 0; i < heap_thread_block::counter_count; i++) {
+			retired[i].store(0, boost::memory_order_relaxed);
+		}
+	}
+
+	/*
+		     ,   -,
+		    mutex    
+	*/
+	void lock() {
+		while (lock_flag.exchange(true, boost::memory_order_acquire)) {
+		}
+	}
+
+	void unlock() {
+		lock_flag.store(false, boost::memory_order_release);
+	}
+
+	static unsigned long current_thread_id() {
+#if defined(__linux__)
+		return (unsigned long)::syscall(SYS_gettid);
+#elif defined(BOOST_WINDOWS)
+		return (unsigned long)boost::winapi::GetCurrentThreadId();
+#else
+		return 0;
+#endif
+	}
+
+	static heap_thread_block* allocate_block();
+
+	heap_thread_block* acquire_block() {
+		thread_state() = eThreadRegistering;
+
+		heap_thread_block* block = NULL;
+		for (heap_thread_block* cur = head.load(boost::memory_order_acquire); cur; cur = cur->next) {
+			bool expected = false;
+			if (!cur->in_use.load(boost::memory_order_relaxed) && cur->in_use.compare_exchange_strong(expected, true, boost::memory_order_acquire)) {
+				block = cur;
+				break;
+			}
+		}
+
+		if (!block) {
+			block = allocate_block();
+			if (!block) {
+				thread_state() = eThreadNone;
+				return NULL;
+			}
+
+			for (std::size_t i = 0; i < heap_thread_block::counter_count; i++) {
+				new (&block->counters[i]) boost::atomic<boost::uint64_t>(0);
+			}
+
+			new (&block->in_use) boost::atomic<bool>(true);
+			block->next = head.load(boost::memory_order_relaxed);
+			while (!head.compare_exchange_weak(block->next, block, boost::memory_order_release, boost::memory_order_relaxed)) {
+			}
+		}
+
+		block->thread_id = current_thread_id();
+		thread_block() = block;
+
+		/*
+			      ;   
+			  ,      
+		*/
+		static thread_local thread_exit_guard guard;
+		(void)guard;
+
+		thread_state() = eThreadActive;
+		return block;
+	}
+
+	void release_thread() {
+		heap_thread_block* block = thread_block();
+		thread_state() = eThreadExited;
+		thread_block() = NULL;
+		if (!block) return;
+
+		lock();
+		for (std::size_t i = 0; i < heap_thread_block::counter_count; i++) {
+			retired[i].fetch_add(block->counters[i].load(boost::memory_order_relaxed), boost::memory_order_relaxed);
+			block->counters[i].store(0, boost::memory_order_relaxed);
+		}
+
+		block->in_use.store(false, boost::memory_order_release);
+		unlock();
+	}
+
+	static void add_counters(HeapStatisticsStruct& statistics, const boost::atomic<boost::uint64_t>* counters) {
+		statistics.Allocations += counters[heap_thread_block::allocations].load(boost::memory_order_relaxed);
+		statistics.Frees += counters[heap_thread_block::frees].load(boost::memory_order_relaxed);
+		statistics.AllocatedBytes += counters[heap_thread_block::allocated_bytes].load(boost::memory_order_relaxed);
+		statistics.FreedBytes += counters[heap_thread_block::freed_bytes].load(boost::memory_order_relaxed);
+
+		for (std::size_t i = 0; i < heap_size_class_count; i++) {
+			statistics.SizeClasses[i] += counters[heap_thread_block::size_classes + i].load(boost::memory_order_relaxed);
+		}
+	}
+
+	/*
+		   -  thread_local    ,
+		           TLS
+	*/
+	static heap_thread_block*& thread_block() {
+		static thread_local heap_thread_block* block = NULL;
+		return block;
+	}
+
+	static int& thread_state() {
+		static thread_local int state = eThreadNone;
+		return state;
+	}
+
+	/*
+		          
+		 
+	*/
+	void add_retired(std::size_t index, boost::uint64_t value) {
+		retired[index].fetch_add(value, boost::memory_order_relaxed);
+	}
+
+public:
+	static heap_registry& instance() {
+		static heap_registry registry;
+		return registry;
+	}
+
+	void record_allocation(std::size_t requested_size, std::size_t block_size) {
+		heap_thread_block* block = thread_block();
+		if (BOOST_UNLIKELY(!block)) {
+			if (thread_state() == eThreadNone) block = acquire_block();
+
+			if (!block) {
+				add_retired(heap_thread_block::allocations, 1);
+				add_retired(heap_thread_block::allocated_bytes, block_size);
+				add_retired(heap_thread_block::size_classes + heap_size_class(requested_size), 1);
+				return;
+			}
+
+			has_records.store(true, boost::memory_order_relaxed);
+		}
+
+		block->add(heap_thread_block::allocations, 1);
+		block->add(heap_thread_block::allocated_bytes, block_size);
+		block->add(heap_thread_block::size_classes + heap_size_class(requested_size), 1);
+	}
+
+	void record_free(std::size_t block_size) {
+		heap_thread_block* block = thread_block();
+		if (BOOST_UNLIKELY(!block)) {
+			if (thread_state() == eThreadNone) block = acquire_block();
+
+			if (!block) {
+				add_retired(heap_thread_block::frees, 1);
+				add_retired(heap_thread_block::freed_bytes, block_size);
+				return;
+			}
+		}
+
+		block->add(heap_thread_block::frees, 1);
+		block->add(heap_thread_block::freed_bytes, block_size);
+	}
+
+	bool is_active() const {
+		return has_records.load(boost::memory_order_relaxed);
+	}
+
+	void get_statistics(HeapStatisticsStruct& statistics) {
+		std::memset(&statistics, 0, sizeof(statistics));
+
+		lock();
+		add_counters(statistics, retired);
+		for (heap_thread_block* cur = head.load(boost::memory_order_acquire); cur; cur = cur->next) {
+			add_counters(statistics, cur->counters);
+		}
+		unlock();
+	}
+
+	/*
+		   -,     
+		:        
+	*/
+	void get_thread_statistics(boost::container::vector<HeapThreadStatisticsStruct>& thread_statistics) {
+		std::size_t block_count = 0;
+		for (heap_thread_block* cur = head.load(boost::memory_order_acquire); cur; cur = cur->next) {
+			block_count++;
+		}
+
+		thread_statistics.resize(block_count);
+		std::size_t count = 0;
+
+		lock();
+		for (heap_thread_block* cur = head.load(boost::memory_order_acquire); cur && count < block_count; cur = cur->next) {
+			if (!cur->in_use.load(boost::memory_order_acquire)) continue;
+
+			HeapThreadStatisticsStruct& statistics = thread_statistics[count++];
+			std::memset(&statistics, 0, sizeof(statistics));
+			statistics.ThreadId = cur->thread_id;
+			add_counters(statistics.Statistics, cur->counters);
+		}
+		unlock();
+
+		thread_statistics.resize(count);
+	}
+
+	/*
+		  .    ,  
+		  ,    .
+	*/
+	void get_current_thread_statistics(HeapStatisticsStruct& statistics) {
+		std::memset(&statistics, 0, sizeof(statistics));
+
+		heap_thread_block* block = thread_block();
+		if (block) add_counters(statistics, block->counters);
+	}
+};
+
+inline heap_thread_block* heap_registry::allocate_block() {
+#if defined(BOOST_WINDOWS)
+	return (heap_thread_block*)::_aligned_malloc(sizeof(heap_thread_block), 64);
+#else
+	void* block = NULL;
+	return ::posix_memalign(&block, 64, sizeof(heap_thread_block)) ? NULL : (heap_thread_block*)block;
+#endif
+}
+
+/*
+	      .     :
+	  heap_counter_hooks.hpp      
+	,      operator new  delete.  Linux 
+	glibc     BOOST_PERFOMANCE_HEAP_COUNTER_MALLOC_HOOKS - 
+	 malloc, free   ,    
+	 C-.
+
+	  is_active()  false,   .
+*/
+class heap_counter {
+private:
+	heap_registry& registry;
+
+public:
+	heap_counter() : registry(heap_registry::instance()) {}
+
+	bool is_active() const {
+		return registry.is_active();
+	}
+
+	/*
+		   ,  
+	*/
+	bool get_statistics(HeapStatisticsStruct& statistics) {
+		registry.get_statistics(statistics);
+		return registry.is_active();
+	}
+
+	/*
+		   
+	*/
+	bool get_thread_statistics(boost::container::vector<HeapThreadStatisticsStruct>& thread_statistics) {
+		registry.get_thread_statistics(thread_statistics);
+		return registry.is_active();
+	}
+
+	bool get_current_thread_statistics(HeapStatisticsStruct& statistics) {
+		registry.get_current_thread_statistics(statistics);
+		return registry.is_active();
+	}
+
+	/*
+		     ,    - 0 ( )
+	*/
+	static std::size_t get_size_class_limit(std::size_t size_class) {
+		return size_class < heap_size_class_count - 1 ? (std::size_t)16 << size_class : 0;
+	}
+};
+
+namespace heap_hooks {
+
+inline std::size_t usable_size(void* pointer, std::size_t requested_size) {
+#if defined(__linux__)
+	(void)requested_size;
+	return ::malloc_usable_size(pointer);
+#elif defined(BOOST_WINDOWS)
+	(void)requested_size;
+	return ::_msize(pointer);
+#else
+	(void)pointer;
+	return requested_size;
+#endif
+}
+
+inline void* allocate(std::size_t size) {
+	for (;;) {
+		void* pointer = std::malloc(size ? size : 1);
+		if (BOOST_LIKELY(pointer != NULL)) {
+			heap_registry::instance().record_allocation(size, usable_size(pointer, size));
+			return pointer;
+		}
+
+		std::new_handler handler = std::get_new_handler();
+		if (!handler) throw std::bad_alloc();
+		handler();
+	}
+}
+
+inline void* allocate_nothrow(std::size_t size) BOOST_NOEXCEPT {
+	try {
+		return allocate(size);
+	} catch (...) {
+		return NULL;
+	}
+}
+
+inline void deallocate(void* pointer) BOOST_NOEXCEPT {
+	if (!pointer) return;
+
+	heap_registry::instance().record_free(usable_size(pointer, 0));
+	std::free(pointer);
+}
+
+#ifdef __cpp_aligned_new
+inline void* allocate_aligned(std::size_t size, std::size_t alignment) {
+	if (!size) size = 1;
+
+	for (;;) {
+#if defined(BOOST_WINDOWS)
+		void* pointer = ::_aligned_malloc(size, alignment);
+		std::size_t block_size = pointer ? ::_aligned_msize(pointer, alignment, 0) : 0;
+#else
+		void* pointer = NULL;
+		if (::posix_memalign(&pointer, alignment < sizeof(void*) ? sizeof(void*) : alignment, size)) pointer = NULL;
+		std::size_t block_size = pointer ? usable_size(pointer, size) : 0;
+#endif
+		if (BOOST_LIKELY(pointer != NULL)) {
+			heap_registry::instance().record_allocation(size, block_size);
+			return pointer;
+		}
+
+		std::new_handler handler = std::get_new_handler();
+		if (!handler) throw std::bad_alloc();
+		handler();
+	}
+}
+
+inline void* allocate_aligned_nothrow(std::size_t size, std::size_t alignment) BOOST_NOEXCEPT {
+	try {
+		return allocate_aligned(size, alignment);
+	} catch (...) {
+		return NULL;
+	}
+}
+
+inline void deallocate_aligned(void* pointer, std::size_t alignment) BOOST_NOEXCEPT {
+	if (!pointer) return;
+
+#if defined(BOOST_WINDOWS)
+	heap_registry::instance().record_free(::_aligned_msize(pointer, alignment, 0));
+	::_aligned_free(pointer);
+#else
+	(void)alignment;
+	heap_registry::instance().record_free(usable_size(pointer, 0));
+	std::free(pointer);
+#endif
+}
+#endif
+
+}
+
+}}}
+#endif
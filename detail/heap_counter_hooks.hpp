@@ -0,0 +1,166 @@
+#ifndef BOOST_PERFOMANCE_HEAP_COUNTER_HOOKS_HPP
+#define BOOST_PERFOMANCE_HEAP_COUNTER_HOOKS_HPP
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#pragma once
+#endif
+
+/*
+	    heap_counter.    
+	   (  ,    
+	  ),   operator new    .
+*/
+#include "heap_counter.hpp"
+
+#if defined(BOOST_PERFOMANCE_HEAP_COUNTER_MALLOC_HOOKS) && defined(__GLIBC__)
+
+/*
+	operator new  libstdc++   malloc,     
+*/
+extern "C" {
+void* __libc_malloc(std::size_t);
+void* __libc_calloc(std::size_t, std::size_t);
+void* __libc_realloc(void*, std::size_t);
+void* __libc_memalign(std::size_t, std::size_t);
+void __libc_free(void*);
+
+void* malloc(std::size_t size) {
+	void* pointer = __libc_malloc(size);
+	if (pointer) boost::perfomance::detail::heap_registry::instance().record_allocation(size, ::malloc_usable_size(pointer));
+	return pointer;
+}
+
+void* calloc(std::size_t count, std::size_t size) {
+	void* pointer = __libc_calloc(count, size);
+	if (pointer) boost::perfomance::detail::heap_registry::instance().record_allocation(count * size, ::malloc_usable_size(pointer));
+	return pointer;
+}
+
+void* realloc(void* old_pointer, std::size_t size) {
+	std::size_t old_size = old_pointer ? ::malloc_usable_size(old_pointer) : 0;
+	void* pointer = __libc_realloc(old_pointer, size);
+
+	if (pointer || !size) {
+		if (old_pointer) boost::perfomance::detail::heap_registry::instance().record_free(old_size);
+		if (pointer) boost::perfomance::detail::heap_registry::instance().record_allocation(size, ::malloc_usable_size(pointer));
+	}
+
+	return pointer;
+}
+
+void* memalign(std::size_t alignment, std::size_t size) {
+	void* pointer = __libc_memalign(alignment, size);
+	if (pointer) boost::perfomance::detail::heap_registry::instance().record_allocation(size, ::malloc_usable_size(pointer));
+	return pointer;
+}
+
+void* aligned_alloc(std::size_t alignment, std::size_t size) {
+	return memalign(alignment, size);
+}
+
+int posix_memalign(void** result, std::size_t alignment, std::size_t size) {
+	if (!alignment || (alignment & (alignment - 1)) || alignment % sizeof(void*)) return EINVAL;
+
+	void* pointer = memalign(alignment, size);
+	if (!pointer) return ENOMEM;
+
+	*result = pointer;
+	return 0;
+}
+
+void free(void* pointer) {
+	if (!pointer) return;
+
+	boost::perfomance::detail::heap_registry::instance().record_free(::malloc_usable_size(pointer));
+	__libc_free(pointer);
+}
+}
+
+#else
+
+void* operator new(std::size_t size) {
+	return boost::perfomance::detail::heap_hooks::allocate(size);
+}
+
+void* operator new[](std::size_t size) {
+	return boost::perfomance::detail::heap_hooks::allocate(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) BOOST_NOEXCEPT {
+	return boost::perfomance::detail::heap_hooks::allocate_nothrow(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) BOOST_NOEXCEPT {
+	return boost::perfomance::detail::heap_hooks::allocate_nothrow(size);
+}
+
+void operator delete(void* pointer) BOOST_NOEXCEPT {
+	boost::perfomance::detail::heap_hooks::deallocate(pointer);
+}
+
+void operator delete[](void* pointer) BOOST_NOEXCEPT {
+	boost::perfomance::detail::heap_hooks::deallocate(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) BOOST_NOEXCEPT {
+	boost::perfomance::detail::heap_hooks::deallocate(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) BOOST_NOEXCEPT {
+	boost::perfomance::detail::heap_hooks::deallocate(pointer);
+}
+
+#ifdef __cpp_sized_deallocation
+void operator delete(void* pointer, std::size_t) BOOST_NOEXCEPT {
+	boost::perfomance::detail::heap_hooks::deallocate(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) BOOST_NOEXCEPT {
+	boost::perfomance::detail::heap_hooks::deallocate(pointer);
+}
+#endif
+
+#ifdef __cpp_aligned_new
+void* operator new(std::size_t size, std::align_val_t alignment) {
+	return boost::perfomance::detail::heap_hooks::allocate_aligned(size, (std::size_t)alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+	return boost::perfomance::detail::heap_hooks::allocate_aligned(size, (std::size_t)alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) BOOST_NOEXCEPT {
+	return boost::perfomance::detail::heap_hooks::allocate_aligned_nothrow(size, (std::size_t)alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) BOOST_NOEXCEPT {
+	return boost::perfomance::detail::heap_hooks::allocate_aligned_nothrow(size, (std::size_t)alignment);
+}
+
+void operator delete(void* pointer, std::align_val_t alignment) BOOST_NOEXCEPT {
+	boost::perfomance::detail::heap_hooks::deallocate_aligned(pointer, (std::size_t)alignment);
+}
+
+void operator delete[](void* pointer, std::align_val_t alignment) BOOST_NOEXCEPT {
+	boost::perfomance::detail::heap_hooks::deallocate_aligned(pointer, (std::size_t)alignment);
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t alignment) BOOST_NOEXCEPT {
+	boost::perfomance::detail::heap_hooks::deallocate_aligned(pointer, (std::size_t)alignment);
+}
+
+void operator delete[](void* pointer, std::size_t, std::align_val_t alignment) BOOST_NOEXCEPT {
+	boost::perfomance::detail::heap_hooks::deallocate_aligned(pointer, (std::size_t)alignment);
+}
+
+void operator delete(void* pointer, std::align_val_t alignment, const std::nothrow_t&) BOOST_NOEXCEPT {
+	boost::perfomance::detail::heap_hooks::deallocate_aligned(pointer, (std::size_t)alignment);
+}
+
+void operator delete[](void* pointer, std::align_val_t alignment, const std::nothrow_t&) BOOST_NOEXCEPT {
+	boost::perfomance::detail::heap_hooks::deallocate_aligned(pointer, (std::size_t)alignment);
+}
+#endif
+
+#endif
+#endif
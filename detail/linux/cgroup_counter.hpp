@@ -0,0 +1,343 @@
+#ifndef BOOST_CGROUP_COUNTER_LINUX_HPP
+#define BOOST_CGROUP_COUNTER_LINUX_HPP
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <sched.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <boost/cstdint.hpp>
+#include <boost/chrono.hpp>
+#include <boost/container/vector.hpp>
+#include "proc_file.hpp"
+
+namespace boost { namespace perfomance { namespace detail { namespace linux_ {
+
+typedef struct {
+	double CpuQuota;							//  : min(cpu.max, affinity)
+	float CpuLoad;								//   CpuQuota
+	float ThrottledFraction;					//  ,     
+	unsigned long long ThrottledMicroseconds;	//     
+	float CpuPressureSome;						// avg10  cpu.pressure, 
+	float CpuPressureFull;
+	unsigned long long StallMicroseconds;		//  total "some"   
+} CgroupCpuStruct;
+
+typedef struct {
+	unsigned long long MemoryCurrent;
+	unsigned long long MemoryLimit;				// ~0ull,   
+	unsigned long long MemoryHeadroom;			//    
+	unsigned long long AnonymousMemory;			// anon  memory.stat
+	unsigned long long FileMemory;				// file  memory.stat ( )
+} CgroupMemoryStruct;
+
+/*
+	 cgroup v2  .      (cpu.max)
+	 memory.max,       ,   
+	 ,    -   .
+
+	      /proc/self/cgroup   
+	cgroup2  /proc/self/mountinfo,      .
+	   (  )  ,  
+	    .
+*/
+class cgroup_counter {
+private:
+	int cgroup_fd;
+	long online_cpu_count;
+
+	proc_file cpu_max_file;
+	proc_file cpu_stat_file;
+	proc_file cpu_pressure_file;
+	proc_file memory_current_file;
+	proc_file memory_max_file;
+	proc_file memory_stat_file;
+
+	unsigned long long prev_usage;
+	unsigned long long prev_periods;
+	unsigned long long prev_throttled_periods;
+	unsigned long long prev_throttled_usec;
+	unsigned long long prev_stall_total;
+	boost::uint64_t prev_timestamp;
+
+	cgroup_counter(const cgroup_counter&);
+	cgroup_counter& operator=(const cgroup_counter&);
+
+	static boost::uint64_t steady_microseconds() {
+		return (boost::uint64_t)boost::chrono::duration_cast<boost::chrono::microseconds>(
+			boost::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	static void copy_token(text_scanner& scanner, char* buffer, std::size_t buffer_size) {
+		scanner.skip_spaces();
+		const char* token = scanner.cur;
+		scanner.skip_token();
+
+		std::size_t token_size = (std::size_t)(scanner.cur - token);
+		if (token_size >= buffer_size) token_size = buffer_size - 1;
+		std::memcpy(buffer, token, token_size);
+		buffer[token_size] = '\0';
+	}
+
+	/*
+		  cgroup2     .   mountinfo:
+		"id parent major:minor root mount_point options [optional...] - fstype source ..."
+	*/
+	static bool find_cgroup2_mount(char* mount_point, char* mount_root, std::size_t buffer_size) {
+		proc_file mountinfo_file("/proc/self/mountinfo", 16384);
+		if (!mountinfo_file.read()) return false;
+
+		text_scanner scanner(mountinfo_file);
+		while (!scanner.eof()) {
+			text_scanner line = scanner;
+			scanner.next_line();
+
+			line.skip_token();
+			line.skip_token();
+			line.skip_token();
+			copy_token(line, mount_root, buffer_size);
+			copy_token(line, mount_point, buffer_size);
+
+			const char* line_end = scanner.cur;
+			text_scanner tail(line.cur, line_end);
+			while (!tail.at_line_end()) {
+				tail.skip_spaces();
+				if (tail.skip_prefix("- cgroup2 ", 10)) return true;
+				tail.skip_token();
+			}
+		}
+
+		return false;
+	}
+
+	/*
+		    "0::/path"  /proc/self/cgroup
+	*/
+	static bool find_cgroup2_path(char* path, std::size_t buffer_size) {
+		proc_file cgroup_file("/proc/self/cgroup");
+		if (!cgroup_file.read()) return false;
+
+		text_scanner scanner(cgroup_file);
+		if (!scanner.find_line("0::", 3)) return false;
+
+		const char* path_begin = scanner.cur;
+		scanner.next_line();
+
+		std::size_t path_size = (std::size_t)(scanner.cur - path_begin);
+		if (path_size && path_begin[path_size - 1] == '\n') path_size--;
+		if (path_size >= buffer_size) return false;
+
+		std::memcpy(path, path_begin, path_size);
+		path[path_size] = '\0';
+		return true;
+	}
+
+	bool open_cgroup(const char* cgroup_path) {
+		char full_path[4096];
+
+		if (cgroup_path) {
+			cgroup_fd = ::open(cgroup_path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+			return cgroup_fd >= 0;
+		}
+
+		char mount_point[1024];
+		char mount_root[1024];
+		char path[2048];
+		if (!find_cgroup2_mount(mount_point, mount_root, sizeof(mount_point)) || !find_cgroup2_path(path, sizeof(path))) return false;
+
+		/*
+			     (    cgroupns),
+			          
+		*/
+		const char* relative_path = path;
+		std::size_t root_size = std::strlen(mount_root);
+		if (root_size > 1 && !std::strncmp(path, mount_root, root_size)) relative_path += root_size;
+
+		std::snprintf(full_path, sizeof(full_path), "%s%s", mount_point, relative_path);
+		cgroup_fd = ::open(full_path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+		return cgroup_fd >= 0;
+	}
+
+	/*
+		    cpu.max ("max 100000"  "400000 100000")  
+		   (cpuset)
+	*/
+	double read_cpu_quota() {
+		double ret_value = (double)online_cpu_count;
+
+		cpu_set_t cpu_set;
+		if (::sched_getaffinity(0, sizeof(cpu_set), &cpu_set) == 0 && CPU_COUNT(&cpu_set) > 0) {
+			ret_value = (double)CPU_COUNT(&cpu_set);
+		}
+
+		if (cpu_max_file.read_head()) {
+			text_scanner scanner(cpu_max_file);
+			unsigned long long quota = 0;
+			unsigned long long period = 0;
+
+			if (scanner.parse(quota) && scanner.parse(period) && period) {
+				double quota_cpus = (double)quota / (double)period;
+				if (quota_cpus < ret_value) ret_value = quota_cpus;
+			}
+		}
+
+		return ret_value;
+	}
+
+	static bool find_value(const proc_file& file, const char* name, std::size_t name_size, unsigned long long& value) {
+		text_scanner scanner(file);
+		return scanner.find_line(name, name_size) && scanner.parse(value);
+	}
+
+	void open_file(proc_file& file, const char* name) {
+		file.open(name, 4096, cgroup_fd);
+	}
+
+public:
+	/*
+		cgroup_path -     .      .
+	*/
+	explicit cgroup_counter(const char* cgroup_path = NULL) : cgroup_fd(-1), online_cpu_count(1),
+		prev_usage(0), prev_periods(0), prev_throttled_periods(0), prev_throttled_usec(0), prev_stall_total(0), prev_timestamp(0) {
+		online_cpu_count = ::sysconf(_SC_NPROCESSORS_ONLN);
+		if (online_cpu_count < 1) online_cpu_count = 1;
+
+		if (!open_cgroup(cgroup_path)) return;
+
+		open_file(cpu_max_file, "cpu.max");
+		open_file(cpu_stat_file, "cpu.stat");
+		open_file(cpu_pressure_file, "cpu.pressure");
+		open_file(memory_current_file, "memory.current");
+		open_file(memory_max_file, "memory.max");
+		open_file(memory_stat_file, "memory.stat");
+
+		/*
+			    
+		*/
+		CgroupCpuStruct cpu_statistics;
+		get_cpu_statistics(cpu_statistics);
+	}
+
+	~cgroup_counter() {
+		if (cgroup_fd >= 0) ::close(cgroup_fd);
+	}
+
+	bool is_available() const {
+		return cgroup_fd >= 0;
+	}
+
+	/*
+		    .    
+		      hardware_concurrency.
+	*/
+	bool get_cpu_quota(double& cpu_quota) {
+		cpu_quota = read_cpu_quota();
+		return true;
+	}
+
+	/*
+		      
+	*/
+	bool get_cpu_statistics(CgroupCpuStruct& cpu_statistics) {
+		if (!cpu_stat_file.read()) return false;
+
+		boost::uint64_t timestamp = steady_microseconds();
+		unsigned long long usage = 0;
+		unsigned long long periods = 0;
+		unsigned long long throttled_periods = 0;
+		unsigned long long throttled_usec = 0;
+
+		if (!find_value(cpu_stat_file, "usage_usec", 10, usage)) return false;
+		find_value(cpu_stat_file, "nr_periods", 10, periods);
+		find_value(cpu_stat_file, "nr_throttled", 12, throttled_periods);
+		find_value(cpu_stat_file, "throttled_usec", 14, throttled_usec);
+
+		cpu_statistics.CpuQuota = read_cpu_quota();
+		cpu_statistics.CpuLoad = 0.f;
+		cpu_statistics.ThrottledFraction = 0.f;
+		cpu_statistics.ThrottledMicroseconds = 0;
+
+		if (prev_timestamp && timestamp > prev_timestamp && usage >= prev_usage) {
+			double available = (double)(timestamp - prev_timestamp) * cpu_statistics.CpuQuota;
+			cpu_statistics.CpuLoad = (float)((double)(usage - prev_usage) / available);
+		}
+
+		if (periods > prev_periods && throttled_periods >= prev_throttled_periods) {
+			cpu_statistics.ThrottledFraction = (float)(throttled_periods - prev_throttled_periods) / (float)(periods - prev_periods);
+		}
+
+		if (throttled_usec > prev_throttled_usec) cpu_statistics.ThrottledMicroseconds = throttled_usec - prev_throttled_usec;
+
+		/*
+			"some avg10=0.00 avg60=0.00 avg300=0.00 total=0",     "full"
+		*/
+		cpu_statistics.CpuPressureSome = 0.f;
+		cpu_statistics.CpuPressureFull = 0.f;
+		cpu_statistics.StallMicroseconds = 0;
+
+		if (cpu_pressure_file.read_head()) {
+			text_scanner scanner(cpu_pressure_file);
+			double average = 0.0;
+			unsigned long long stall_total = 0;
+
+			if (scanner.find_line("some avg10=", 11) && scanner.parse(average)) {
+				cpu_statistics.CpuPressureSome = (float)average;
+				scanner.skip_token();
+				scanner.skip_token();
+				scanner.skip_spaces();
+				if (scanner.skip_prefix("total=", 6)) scanner.parse(stall_total);
+			}
+
+			if (stall_total > prev_stall_total && prev_timestamp) cpu_statistics.StallMicroseconds = stall_total - prev_stall_total;
+			prev_stall_total = stall_total;
+
+			text_scanner full_scanner(cpu_pressure_file);
+			if (full_scanner.find_line("full avg10=", 11) && full_scanner.parse(average)) {
+				cpu_statistics.CpuPressureFull = (float)average;
+			}
+		}
+
+		prev_usage = usage;
+		prev_periods = periods;
+		prev_throttled_periods = throttled_periods;
+		prev_throttled_usec = throttled_usec;
+		prev_timestamp = timestamp;
+		return true;
+	}
+
+	/*
+		      memory.max
+	*/
+	bool get_memory_statistics(CgroupMemoryStruct& memory_statistics) {
+		if (!memory_current_file.read_head()) return false;
+
+		text_scanner current_scanner(memory_current_file);
+		if (!current_scanner.parse(memory_statistics.MemoryCurrent)) return false;
+
+		memory_statistics.MemoryLimit = ~0ull;
+		if (memory_max_file.read_head()) {
+			text_scanner max_scanner(memory_max_file);
+			max_scanner.parse(memory_statistics.MemoryLimit);
+		}
+
+		memory_statistics.MemoryHeadroom = memory_statistics.MemoryLimit > memory_statistics.MemoryCurrent ?
+			memory_statistics.MemoryLimit - memory_statistics.MemoryCurrent : 0;
+
+		memory_statistics.AnonymousMemory = 0;
+		memory_statistics.FileMemory = 0;
+		if (memory_stat_file.read()) {
+			find_value(memory_stat_file, "anon ", 5, memory_statistics.AnonymousMemory);
+			find_value(memory_stat_file, "file ", 5, memory_statistics.FileMemory);
+		}
+
+		return true;
+	}
+};
+
+}}}}
+#endif
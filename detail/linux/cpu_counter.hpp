@@ -0,0 +1,202 @@
+#ifndef BOOST_CPU_COUNTER_LINUX_HPP
+#define BOOST_CPU_COUNTER_LINUX_HPP
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#include <boost/cstdint.hpp>
+#include <boost/container/vector.hpp>
+#include "../load_kernel.hpp"
+#include "proc_file.hpp"
+
+namespace boost { namespace perfomance { namespace detail { namespace linux_ {
+
+class cpu_counter {
+private:
+	unsigned long cpu_count;
+
+	/*
+		/proc/stat       pread,    
+		        .
+	*/
+	proc_file stat_file;
+
+	unsigned long long total_idle_time;
+	unsigned long long total_time;
+	unsigned long long prev_total_idle_time;
+	unsigned long long prev_total_time;
+
+	/*
+		      ,  calculate_core_load
+		  
+	*/
+	boost::container::vector<boost::uint64_t> core_idle_time;
+	boost::container::vector<boost::uint64_t> core_total_time;
+	boost::container::vector<boost::uint64_t> prev_core_idle_time;
+	boost::container::vector<boost::uint64_t> prev_core_total_time;
+
+	inline float calculate_load(unsigned long long idle, unsigned long long total, unsigned long long& prev_idle, unsigned long long& prev_total) {
+		/*
+			iowait  ,      
+			 total.   ,   load_kernels::scalar_step,  
+			           .
+		*/
+		unsigned long long delta_total = total - prev_total;
+		unsigned long long delta_idle = idle - prev_idle;
+		if (delta_idle > delta_total) delta_idle = delta_total;
+
+		prev_idle = idle;
+		prev_total = total;
+
+		/*
+			       (   
+			 ),    finish_load   
+		*/
+		return load_kernels::finish_load((double)delta_idle, (double)delta_total);
+	}
+
+	/*
+		   "cpuN user nice system idle iowait irq softirq steal guest guest_nice".
+		guest  guest_nice    user  nice,    .
+	*/
+	static bool parse_cpu_line(text_scanner& scanner, unsigned long long& idle, unsigned long long& total) {
+		unsigned long long fields[8] = {};
+		for (size_t i = 0; i < 8; i++) {
+			if (!scanner.parse(fields[i])) {
+				/*
+					    ,   
+				*/
+				if (i < 4) return false;
+				break;
+			}
+		}
+
+		idle = fields[3] + fields[4];
+		total = 0;
+		for (size_t i = 0; i < 8; i++) {
+			total += fields[i];
+		}
+
+		return true;
+	}
+
+	bool read_proc_stat() {
+		for (;;) {
+			if (!stat_file.read_head()) return false;
+
+			text_scanner scanner(stat_file);
+			bool truncated = false;
+
+			while (!scanner.eof()) {
+				/*
+					,    ,   , 
+					      
+				*/
+				if (!std::memchr(scanner.cur, '\n', (std::size_t)(scanner.end - scanner.cur)) && stat_file.is_full()) {
+					truncated = true;
+					break;
+				}
+
+				if (!scanner.skip_prefix("cpu", 3)) return true;
+
+				if (!scanner.eof() && *scanner.cur == ' ') {
+					if (!parse_cpu_line(scanner, total_idle_time, total_time)) return false;
+				} else {
+					unsigned long long cpu_index = 0;
+					unsigned long long idle = 0;
+					unsigned long long total = 0;
+
+					if (!scanner.parse(cpu_index) || !parse_cpu_line(scanner, idle, total)) return false;
+					if (cpu_index < cpu_count) {
+						core_idle_time[cpu_index] = idle;
+						core_total_time[cpu_index] = total;
+					}
+				}
+
+				scanner.next_line();
+			}
+
+			if (!truncated) return true;
+
+			/*
+				  cpu     ,   
+				      
+			*/
+			stat_file.grow();
+		}
+	}
+
+	void open(const char* stat_path, unsigned long core_count) {
+		cpu_count = core_count ? core_count : 1;
+
+		/*
+			    /proc/stat     100 , 
+			   intr,     
+		*/
+		if (stat_file.open(stat_path, 4096 + cpu_count * 128)) {
+			core_idle_time.resize(cpu_count);
+			core_total_time.resize(cpu_count);
+			prev_core_idle_time.resize(cpu_count);
+			prev_core_total_time.resize(cpu_count);
+
+			/*
+				     ,    ,
+				   get_load       
+			*/
+			if (read_proc_stat()) {
+				prev_total_idle_time = total_idle_time;
+				prev_total_time = total_time;
+				prev_core_idle_time = core_idle_time;
+				prev_core_total_time = core_total_time;
+			}
+		}
+	}
+
+public:
+	cpu_counter() : total_idle_time(0), total_time(0), prev_total_idle_time(0), prev_total_time(0) {
+		long configured_count = ::sysconf(_SC_NPROCESSORS_CONF);
+		open("/proc/stat", configured_count > 0 ? (unsigned long)configured_count : 1);
+	}
+
+	/*
+		      /proc/stat    ,
+		     
+	*/
+	cpu_counter(const char* stat_path, unsigned long core_count) : total_idle_time(0), total_time(0), prev_total_idle_time(0), prev_total_time(0) {
+		open(stat_path, core_count);
+	}
+
+	unsigned long get_cpu_count() const {
+		return cpu_count;
+	}
+
+	bool get_load(float& base_load) {
+		if (!read_proc_stat()) return false;
+		base_load = calculate_load(total_idle_time, total_time, prev_total_idle_time, prev_total_time);
+		return true;
+	}
+
+	bool get_load_per_core(boost::container::vector<float>& vector_load) {
+		float base_load = 0.f;
+		return get_load_per_core(vector_load, base_load);
+	}
+
+	/*
+		            
+	*/
+	bool get_load_per_core(boost::container::vector<float>& vector_load, float& base_load) {
+		if (!read_proc_stat()) return false;
+		vector_load.resize(cpu_count);
+
+		CoreLoadStateStruct state = { &core_idle_time[0], &core_total_time[0], &prev_core_idle_time[0], &prev_core_total_time[0] };
+		base_load = calculate_core_load(state, &vector_load[0], cpu_count);
+		return true;
+	}
+};
+
+}}}}
+#endif
@@ -0,0 +1,369 @@
+#ifndef BOOST_CPUFREQ_COUNTER_LINUX_HPP
+#define BOOST_CPUFREQ_COUNTER_LINUX_HPP
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <boost/cstdint.hpp>
+#include <boost/container/vector.hpp>
+#include "descriptor_cache.hpp"
+#include "proc_file.hpp"
+
+namespace boost { namespace perfomance { namespace detail { namespace linux_ {
+
+enum {
+	eMaxIdleStates = 10		// CPUIDLE_STATE_MAX  
+};
+
+/*
+	,          
+*/
+typedef struct {
+	unsigned long CurrentFrequency;			// scaling_cur_freq, , 0  cpufreq
+	unsigned long EffectiveFrequency;		//      APERF/MPERF, , 0    MSR      
+	unsigned long BaseFrequency;			//  , 
+	unsigned long MaxFrequency;				// cpuinfo_max_freq, 
+	float FrequencyRatio;					// EffectiveFrequency ( CurrentFrequency)  ,  1 -  
+	unsigned long long ThrottleEvents;		//     (core_throttle_count)
+	unsigned long long PackageThrottleEvents;	//     (package_throttle_count)
+	unsigned long long ThrottleTime;		//   , , Linux 6.0+
+	unsigned long IdleStateCount;
+	float IdleResidency[eMaxIdleStates];	//      cpuidle
+} CoreFrequencyStruct;
+
+/*
+	 ,   100%  cpu_counter,   :
+	   cpufreq,      APERF/MPERF 
+	/dev/cpu/<N>/msr (  msr  CAP_SYS_RAWIO),   
+	thermal_throttle        cpuidle.
+
+	 ,  msr,       pread. 
+	        descriptor_cache, 
+	   . ,      ,   .
+	        cpu_counter::get_load_per_core.
+*/
+class cpufreq_counter {
+private:
+	enum ESource {
+		eSourceFrequency = 1,
+		eSourceThrottle = 2,
+		eSourcePackageThrottle = 4,
+		eSourceThrottleTime = 8,
+		eSourceMsr = 16
+	};
+
+	typedef struct {
+		unsigned long Sources;
+		int FrequencyFd;
+		int ThrottleFd;
+		int PackageThrottleFd;
+		int ThrottleTimeFd;
+		int MsrFd;
+		unsigned long BaseFrequency;
+		unsigned long MaxFrequency;
+		unsigned long long Aperf;
+		unsigned long long Mperf;
+		unsigned long long ThrottleCount;
+		unsigned long long PackageThrottleCount;
+		unsigned long long ThrottleTime;
+		unsigned long IdleStateCount;
+		int IdleFd[eMaxIdleStates];
+		unsigned long long IdleTime[eMaxIdleStates];
+	} CoreStateStruct;
+
+	unsigned long cpu_count;
+	int cpu_fd;
+	int msr_fd;
+	descriptor_cache descriptors;
+	boost::container::vector<CoreStateStruct> cores;
+	unsigned long sources;
+	unsigned long idle_state_count;
+	char idle_state_names[eMaxIdleStates][16];
+	boost::uint64_t timestamp;
+	char value_buffer[64];
+
+	cpufreq_counter(const cpufreq_counter&);
+	cpufreq_counter& operator=(const cpufreq_counter&);
+
+	static boost::uint64_t steady_nanoseconds() {
+		timespec now;
+		::clock_gettime(CLOCK_MONOTONIC, &now);
+		return (boost::uint64_t)now.tv_sec * 1000000000ull + (boost::uint64_t)now.tv_nsec;
+	}
+
+	static unsigned long long delta(unsigned long long current, unsigned long long previous) {
+		return current > previous ? current - previous : 0;
+	}
+
+	/*
+		 index  <N>/msr: 8   ,   
+	*/
+	bool read_msr(unsigned long cpu, off_t index, int& fd, unsigned long long& value) {
+		ssize_t read_size = descriptors.read(fd, value_buffer, sizeof(value), index);
+		if (read_size < 0) {
+			char path[32];
+			std::snprintf(path, sizeof(path), "%lu/msr", cpu);
+			read_size = descriptors.open_read(msr_fd, path, fd, value_buffer, sizeof(value), index);
+		}
+
+		if (read_size != (ssize_t)sizeof(value)) return false;
+
+		std::memcpy(&value, value_buffer, sizeof(value));
+		return true;
+	}
+
+	bool parse_value(ssize_t read_size, unsigned long long& value) const {
+		if (read_size <= 0) return false;
+
+		text_scanner scanner(value_buffer, value_buffer + read_size);
+		return scanner.parse(value);
+	}
+
+	/*
+		   cpu<N>/<name>.    ,  
+		 .
+	*/
+	bool read_value(unsigned long cpu, const char* name, int& fd, unsigned long long& value) {
+		ssize_t read_size = descriptors.read(fd, value_buffer, sizeof(value_buffer));
+		if (read_size < 0) {
+			char path[96];
+			std::snprintf(path, sizeof(path), "cpu%lu/%s", cpu, name);
+			read_size = descriptors.open_read(cpu_fd, path, fd, value_buffer, sizeof(value_buffer));
+		}
+
+		return parse_value(read_size, value);
+	}
+
+	bool read_idle_time(unsigned long cpu, unsigned long state, int& fd, unsigned long long& value) {
+		ssize_t read_size = descriptors.read(fd, value_buffer, sizeof(value_buffer));
+		if (read_size < 0) {
+			char path[96];
+			std::snprintf(path, sizeof(path), "cpu%lu/cpuidle/state%lu/time", cpu, state);
+			read_size = descriptors.open_read(cpu_fd, path, fd, value_buffer, sizeof(value_buffer));
+		}
+
+		return parse_value(read_size, value);
+	}
+
+	/*
+		 APERF/MPERF  ,    MPERF: base_frequency  
+		intel_pstate  amd-pstate,  acpi-cpufreq   - cpuinfo_max_freq
+		(     )
+	*/
+	void probe_core(unsigned long cpu) {
+		CoreStateStruct& core = cores[cpu];
+		std::memset(&core, 0, sizeof(core));
+		core.FrequencyFd = core.ThrottleFd = core.PackageThrottleFd = core.ThrottleTimeFd = core.MsrFd = -1;
+		for (int i = 0; i < eMaxIdleStates; i++) core.IdleFd[i] = -1;
+
+		unsigned long long value = 0;
+		int fd = -1;
+		if (read_value(cpu, "cpufreq/cpuinfo_max_freq", fd, value)) core.MaxFrequency = (unsigned long)value;
+		descriptors.release(fd);
+		core.BaseFrequency = core.MaxFrequency;
+		if (read_value(cpu, "cpufreq/base_frequency", fd, value)) core.BaseFrequency = (unsigned long)value;
+		descriptors.release(fd);
+
+		if (read_value(cpu, "cpufreq/scaling_cur_freq", core.FrequencyFd, value)) core.Sources |= eSourceFrequency;
+		if (read_value(cpu, "thermal_throttle/core_throttle_count", core.ThrottleFd, core.ThrottleCount)) core.Sources |= eSourceThrottle;
+		if (read_value(cpu, "thermal_throttle/package_throttle_count", core.PackageThrottleFd, core.PackageThrottleCount)) core.Sources |= eSourcePackageThrottle;
+		if (read_value(cpu, "thermal_throttle/core_throttle_total_time_ms", core.ThrottleTimeFd, core.ThrottleTime)) core.Sources |= eSourceThrottleTime;
+
+		while (core.IdleStateCount < eMaxIdleStates && read_idle_time(cpu, core.IdleStateCount, core.IdleFd[core.IdleStateCount], core.IdleTime[core.IdleStateCount])) {
+			core.IdleStateCount++;
+		}
+
+		if (core.BaseFrequency && msr_fd >= 0) {
+			if (read_msr(cpu, 0xE8, core.MsrFd, core.Aperf) && read_msr(cpu, 0xE7, core.MsrFd, core.Mperf)) {
+				core.Sources |= eSourceMsr;
+			} else {
+				descriptors.release(core.MsrFd);
+			}
+		}
+
+		sources |= core.Sources;
+		if (core.IdleStateCount > idle_state_count) idle_state_count = core.IdleStateCount;
+	}
+
+	/*
+		        ,    
+	*/
+	void read_idle_state_names() {
+		for (unsigned long cpu = 0; cpu < cpu_count; cpu++) {
+			if (cores[cpu].IdleStateCount != idle_state_count) continue;
+
+			for (unsigned long state = 0; state < idle_state_count; state++) {
+				char path[96];
+				std::snprintf(path, sizeof(path), "cpu%lu/cpuidle/state%lu/name", cpu, state);
+				proc_file name_file(path, 64, cpu_fd);
+				if (!name_file.read_head()) continue;
+
+				std::size_t name_size = (std::size_t)(name_file.end() - name_file.begin());
+				while (name_size && (name_file.begin()[name_size - 1] == '\n' || name_file.begin()[name_size - 1] == ' ')) name_size--;
+				if (name_size >= sizeof(idle_state_names[state])) name_size = sizeof(idle_state_names[state]) - 1;
+				std::memcpy(idle_state_names[state], name_file.begin(), name_size);
+				idle_state_names[state][name_size] = '\0';
+			}
+
+			break;
+		}
+	}
+
+	void open(const char* cpu_directory, const char* msr_directory) {
+		std::memset(idle_state_names, 0, sizeof(idle_state_names));
+		cpu_fd = ::open(cpu_directory, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+		if (cpu_fd < 0) return;
+		msr_fd = ::open(msr_directory, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+		cores.resize(cpu_count);
+		for (unsigned long cpu = 0; cpu < cpu_count; cpu++) {
+			probe_core(cpu);
+		}
+
+		read_idle_state_names();
+		timestamp = steady_nanoseconds();
+	}
+
+public:
+	cpufreq_counter() : cpu_fd(-1), msr_fd(-1), sources(0), idle_state_count(0), timestamp(0) {
+		long configured_count = ::sysconf(_SC_NPROCESSORS_CONF);
+		cpu_count = configured_count > 0 ? (unsigned long)configured_count : 1;
+		open("/sys/devices/system/cpu", "/dev/cpu");
+	}
+
+	/*
+		      /sys/devices/system/cpu  /dev/cpu,
+		     .  msr   8  
+		 0xE7  0xE8,    .
+	*/
+	cpufreq_counter(const char* cpu_directory, const char* msr_directory, unsigned long core_count)
+		: cpu_fd(-1), msr_fd(-1), sources(0), idle_state_count(0), timestamp(0) {
+		cpu_count = core_count ? core_count : 1;
+		open(cpu_directory, msr_directory);
+	}
+
+	~cpufreq_counter() {
+		for (std::size_t cpu = 0; cpu < cores.size(); cpu++) {
+			CoreStateStruct& core = cores[cpu];
+			descriptors.release(core.FrequencyFd);
+			descriptors.release(core.ThrottleFd);
+			descriptors.release(core.PackageThrottleFd);
+			descriptors.release(core.ThrottleTimeFd);
+			for (unsigned long state = 0; state < core.IdleStateCount; state++) descriptors.release(core.IdleFd[state]);
+			descriptors.release(core.MsrFd);
+		}
+
+		if (cpu_fd >= 0) ::close(cpu_fd);
+		if (msr_fd >= 0) ::close(msr_fd);
+	}
+
+	unsigned long get_cpu_count() const {
+		return cpu_count;
+	}
+
+	bool has_frequency() const {
+		return (sources & eSourceFrequency) != 0;
+	}
+
+	bool has_effective_frequency() const {
+		return (sources & eSourceMsr) != 0;
+	}
+
+	bool has_throttle_events() const {
+		return (sources & eSourceThrottle) != 0;
+	}
+
+	/*
+		   cpuidle  , 0   cpuidle
+	*/
+	unsigned long get_idle_state_count() const {
+		return idle_state_count;
+	}
+
+	/*
+		   ("POLL", "C1", "C6", ...)    CoreFrequencyStruct::IdleResidency
+	*/
+	const char* get_idle_state_name(unsigned long state) const {
+		return state < idle_state_count ? idle_state_names[state] : "";
+	}
+
+	/*
+		        (  -  
+		).      .  -
+		  pread        .
+	*/
+	bool get_core_frequency(boost::container::vector<CoreFrequencyStruct>& core_frequency) {
+		if (cpu_fd < 0 || (!sources && !idle_state_count)) return false;
+
+		boost::uint64_t now = steady_nanoseconds();
+		double elapsed_microseconds = now > timestamp ? (double)(now - timestamp) * 1e-3 : 0.0;
+		timestamp = now;
+
+		core_frequency.resize(cpu_count);
+		for (unsigned long cpu = 0; cpu < cpu_count; cpu++) {
+			CoreStateStruct& core = cores[cpu];
+			CoreFrequencyStruct& result = core_frequency[cpu];
+			std::memset(&result, 0, sizeof(result));
+			result.BaseFrequency = core.BaseFrequency;
+			result.MaxFrequency = core.MaxFrequency;
+
+			unsigned long long value = 0;
+			if ((core.Sources & eSourceFrequency) && read_value(cpu, "cpufreq/scaling_cur_freq", core.FrequencyFd, value)) {
+				result.CurrentFrequency = (unsigned long)value;
+			}
+
+			/*
+				     C0,    -  
+				    ,   
+			*/
+			unsigned long long aperf = 0;
+			unsigned long long mperf = 0;
+			if ((core.Sources & eSourceMsr) && read_msr(cpu, 0xE8, core.MsrFd, aperf) && read_msr(cpu, 0xE7, core.MsrFd, mperf)) {
+				unsigned long long aperf_delta = delta(aperf, core.Aperf);
+				unsigned long long mperf_delta = delta(mperf, core.Mperf);
+				if (mperf_delta) result.EffectiveFrequency = (unsigned long)((double)core.BaseFrequency * (double)aperf_delta / (double)mperf_delta);
+				core.Aperf = aperf;
+				core.Mperf = mperf;
+			}
+
+			unsigned long frequency = result.EffectiveFrequency ? result.EffectiveFrequency : result.CurrentFrequency;
+			if (core.BaseFrequency) result.FrequencyRatio = (float)frequency / (float)core.BaseFrequency;
+
+			if ((core.Sources & eSourceThrottle) && read_value(cpu, "thermal_throttle/core_throttle_count", core.ThrottleFd, value)) {
+				result.ThrottleEvents = delta(value, core.ThrottleCount);
+				core.ThrottleCount = value;
+			}
+
+			if ((core.Sources & eSourcePackageThrottle) && read_value(cpu, "thermal_throttle/package_throttle_count", core.PackageThrottleFd, value)) {
+				result.PackageThrottleEvents = delta(value, core.PackageThrottleCount);
+				core.PackageThrottleCount = value;
+			}
+
+			if ((core.Sources & eSourceThrottleTime) && read_value(cpu, "thermal_throttle/core_throttle_total_time_ms", core.ThrottleTimeFd, value)) {
+				result.ThrottleTime = delta(value, core.ThrottleTime);
+				core.ThrottleTime = value;
+			}
+
+			result.IdleStateCount = core.IdleStateCount;
+			for (unsigned long state = 0; state < core.IdleStateCount; state++) {
+				if (!read_idle_time(cpu, state, core.IdleFd[state], value)) continue;
+
+				if (elapsed_microseconds > 0) result.IdleResidency[state] = (float)((double)delta(value, core.IdleTime[state]) / elapsed_microseconds);
+				if (result.IdleResidency[state] > 1.f) result.IdleResidency[state] = 1.f;
+				core.IdleTime[state] = value;
+			}
+		}
+
+		return true;
+	}
+};
+
+}}}}
+#endif
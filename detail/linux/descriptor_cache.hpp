@@ -0,0 +1,207 @@
+#ifndef BOOST_DESCRIPTOR_CACHE_LINUX_HPP
+#define BOOST_DESCRIPTOR_CACHE_LINUX_HPP
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <cstdlib>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <boost/atomic.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/lock_guard.hpp>
+
+namespace boost { namespace perfomance { namespace detail { namespace linux_ {
+
+/*
+	     .     
+	RLIMIT_NOFILE:   ,    headroom  
+	  .   descriptor_cache (socket_index,
+	process_scanner, thread_counter, io_counter, cpufreq_counter, memory_counter)
+	  ,        .
+
+	      /dev/null:  
+	    openat  EMFILE,   
+	     ,     .
+*/
+class descriptor_budget {
+private:
+	boost::atomic<std::size_t> cached_count;
+	std::size_t descriptor_limit;
+	boost::mutex spare_mutex;
+	int spare_fd;
+
+	descriptor_budget(const descriptor_budget&);
+	descriptor_budget& operator=(const descriptor_budget&);
+
+	enum { headroom = 64 };
+
+	descriptor_budget() : cached_count(0), descriptor_limit(0), spare_fd(-1) {
+		rlimit limit;
+		if (!::getrlimit(RLIMIT_NOFILE, &limit)) {
+			std::size_t soft_limit = limit.rlim_cur == RLIM_INFINITY || limit.rlim_cur > (rlim_t)(~(std::size_t)0 / 2) ? ~(std::size_t)0 / 2 : (std::size_t)limit.rlim_cur;
+			if (soft_limit > headroom) {
+				descriptor_limit = soft_limit / 2 < soft_limit - headroom ? soft_limit / 2 : soft_limit - headroom;
+			}
+		}
+
+		spare_fd = ::open("/dev/null", O_RDONLY | O_CLOEXEC);
+	}
+
+public:
+	/*
+		  :       
+		     
+	*/
+	static descriptor_budget& instance() {
+		static descriptor_budget* budget = new descriptor_budget();
+		return *budget;
+	}
+
+	std::size_t size() const {
+		return cached_count.load(boost::memory_order_relaxed);
+	}
+
+	std::size_t get_limit() const {
+		return descriptor_limit;
+	}
+
+	bool acquire() {
+		std::size_t count = cached_count.load(boost::memory_order_relaxed);
+		do {
+			if (count >= descriptor_limit) return false;
+		} while (!cached_count.compare_exchange_weak(count, count + 1, boost::memory_order_relaxed));
+
+		return true;
+	}
+
+	void release() {
+		cached_count.fetch_sub(1, boost::memory_order_relaxed);
+	}
+
+	/*
+		    ,   openat   .
+		    read_file    .
+	*/
+	template <class Functor>
+	ssize_t open_with_spare(int dir_fd, const char* path, Functor read_file) {
+		boost::lock_guard<boost::mutex> lock(spare_mutex);
+		if (spare_fd < 0) return -1;
+
+		::close(spare_fd);
+		int fd = ::openat(dir_fd, path, O_RDONLY | O_CLOEXEC);
+
+		ssize_t ret_value = -1;
+		if (fd >= 0) {
+			ret_value = read_file(fd);
+			::close(fd);
+		}
+
+		spare_fd = ::open("/dev/null", O_RDONLY | O_CLOEXEC);
+		return ret_value;
+	}
+};
+
+/*
+	   /proc/<pid>/...,     
+	 (  -  pread  open/read/close).  
+	          , 
+	       descriptor_budget, 
+	   .
+
+	   pread     ESRCH,  
+	 PID    ,     ,
+	       .
+*/
+class descriptor_cache {
+private:
+	std::size_t cached_count;
+	descriptor_budget& budget;
+
+	descriptor_cache(const descriptor_cache&);
+	descriptor_cache& operator=(const descriptor_cache&);
+
+	static ssize_t pread_at(int fd, char* buffer, std::size_t buffer_size, off_t offset) {
+		for (;;) {
+			ssize_t ret_value = ::pread(fd, buffer, buffer_size, offset);
+			if (ret_value >= 0 || errno != EINTR) return ret_value;
+		}
+	}
+
+	struct uncached_read {
+		char* buffer;
+		std::size_t buffer_size;
+		off_t offset;
+
+		uncached_read(char* read_buffer, std::size_t size, off_t read_offset) : buffer(read_buffer), buffer_size(size), offset(read_offset) {}
+
+		ssize_t operator()(int fd) const {
+			return pread_at(fd, buffer, buffer_size, offset);
+		}
+	};
+
+public:
+	descriptor_cache() : cached_count(0), budget(descriptor_budget::instance()) {}
+
+	std::size_t size() const {
+		return cached_count;
+	}
+
+	/*
+		   .     -1,
+		       (  ).
+	*/
+	ssize_t read(int& fd, char* buffer, std::size_t buffer_size, off_t offset = 0) {
+		if (fd < 0) return -1;
+
+		ssize_t ret_value = pread_at(fd, buffer, buffer_size, offset);
+		if (ret_value <= 0) {
+			release(fd);
+			return -1;
+		}
+
+		return ret_value;
+	}
+
+	/*
+		 path  dir_fd     offset.  
+		 fd,         ,   
+		  .
+	*/
+	ssize_t open_read(int dir_fd, const char* path, int& fd, char* buffer, std::size_t buffer_size, off_t offset = 0) {
+		release(fd);
+
+		int new_fd = ::openat(dir_fd, path, O_RDONLY | O_CLOEXEC);
+		if (new_fd < 0) {
+			if (errno != EMFILE && errno != ENFILE) return -1;
+
+			ssize_t ret_value = budget.open_with_spare(dir_fd, path, uncached_read(buffer, buffer_size, offset));
+			return ret_value > 0 ? ret_value : -1;
+		}
+
+		ssize_t ret_value = pread_at(new_fd, buffer, buffer_size, offset);
+		if (ret_value > 0 && budget.acquire()) {
+			fd = new_fd;
+			cached_count++;
+		} else {
+			::close(new_fd);
+		}
+
+		return ret_value > 0 ? ret_value : -1;
+	}
+
+	void release(int& fd) {
+		if (fd < 0) return;
+
+		::close(fd);
+		fd = -1;
+		cached_count--;
+		budget.release();
+	}
+};
+
+}}}}
+#endif
@@ -0,0 +1,283 @@
+#ifndef BOOST_HW_COUNTER_LINUX_HPP
+#define BOOST_HW_COUNTER_LINUX_HPP
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include <boost/cstdint.hpp>
+#include <boost/container/vector.hpp>
+
+namespace boost { namespace perfomance { namespace detail { namespace linux_ {
+
+enum EHardwareCounterScope {
+	eThisThread = 0,	// ,  
+	eThread,			//    TID
+	eProcess,			//      PID (0 -  )
+	eCpu				//      
+};
+
+enum EHardwareEvent {
+	eCycles = 0,
+	eInstructions,
+	eCacheMisses,
+	eBranchMisses,
+	eContextSwitches,
+	eHardwareEventCount
+};
+
+typedef struct {
+	unsigned long long Cycles;
+	unsigned long long Instructions;
+	unsigned long long CacheMisses;			//    
+	unsigned long long BranchMisses;
+	unsigned long long ContextSwitches;
+	float InstructionsPerCycle;
+	float RunningFraction;					//  ,     ()
+	unsigned long AvailableEvents;			//   EHardwareEvent
+} HardwareCountersStruct;
+
+/*
+	    perf_event_open.    
+	  ,     read()   
+	.    ,   
+	 time_enabled / time_running.
+*/
+class hw_counter {
+private:
+	enum {
+		read_header_size = 3	// nr, time_enabled, time_running
+	};
+
+	/*
+		      (  ).   
+		   ,        .
+	*/
+	typedef struct {
+		int LeaderFd;
+		int EventFds[eHardwareEventCount];
+		boost::uint64_t EventIds[eHardwareEventCount];
+		boost::uint64_t PrevValues[eHardwareEventCount];
+		boost::uint64_t PrevTimeEnabled;
+		boost::uint64_t PrevTimeRunning;
+	} EventGroupStruct;
+
+	boost::container::vector<EventGroupStruct> groups;
+	boost::container::vector<boost::uint64_t> read_buffer;
+	unsigned long available_events;
+
+	hw_counter(const hw_counter&);
+	hw_counter& operator=(const hw_counter&);
+
+	static int perf_event_open(perf_event_attr* attr, pid_t pid, int cpu, int group_fd, unsigned long flags) {
+		return (int)::syscall(__NR_perf_event_open, attr, pid, cpu, group_fd, flags);
+	}
+
+	static void fill_event_attr(perf_event_attr& attr, int event, bool exclude_kernel) {
+		std::memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = event == eContextSwitches ? PERF_TYPE_SOFTWARE : PERF_TYPE_HARDWARE;
+
+		switch (event) {
+		case eCycles: attr.config = PERF_COUNT_HW_CPU_CYCLES; break;
+		case eInstructions: attr.config = PERF_COUNT_HW_INSTRUCTIONS; break;
+		case eCacheMisses: attr.config = PERF_COUNT_HW_CACHE_MISSES; break;
+		case eBranchMisses: attr.config = PERF_COUNT_HW_BRANCH_MISSES; break;
+		default: attr.config = PERF_COUNT_SW_CONTEXT_SWITCHES; break;
+		}
+
+		attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_ID | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+		attr.disabled = 1;
+		attr.exclude_hv = 1;
+		attr.exclude_kernel = exclude_kernel ? 1 : 0;
+	}
+
+	static int open_event(int event, pid_t pid, int cpu, int group_fd) {
+		perf_event_attr attr;
+
+		/*
+			 perf_event_paranoid >= 2    
+			   ,       
+		*/
+		fill_event_attr(attr, event, false);
+		int fd = perf_event_open(&attr, pid, cpu, group_fd, PERF_FLAG_FD_CLOEXEC);
+		if (fd < 0 && (errno == EACCES || errno == EPERM)) {
+			fill_event_attr(attr, event, true);
+			fd = perf_event_open(&attr, pid, cpu, group_fd, PERF_FLAG_FD_CLOEXEC);
+		}
+
+		return fd;
+	}
+
+	bool open_group(pid_t pid, int cpu) {
+		EventGroupStruct group;
+		std::memset(&group, 0, sizeof(group));
+		group.LeaderFd = -1;
+
+		/*
+			    ,   :  
+			      ,    
+		*/
+		for (int event = 0; event < eHardwareEventCount; event++) {
+			group.EventFds[event] = open_event(event, pid, cpu, group.LeaderFd);
+			if (group.EventFds[event] < 0) continue;
+
+			if (group.LeaderFd < 0) group.LeaderFd = group.EventFds[event];
+			if (::ioctl(group.EventFds[event], PERF_EVENT_IOC_ID, &group.EventIds[event]) < 0) {
+				if (group.LeaderFd == group.EventFds[event]) group.LeaderFd = -1;
+				::close(group.EventFds[event]);
+				group.EventFds[event] = -1;
+				continue;
+			}
+
+			available_events |= 1ul << event;
+		}
+
+		if (group.LeaderFd < 0) return false;
+
+		::ioctl(group.LeaderFd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+		::ioctl(group.LeaderFd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+		groups.push_back(group);
+		return true;
+	}
+
+	bool open_process(pid_t pid) {
+		char path[64];
+		std::snprintf(path, sizeof(path), "/proc/%d/task", (int)(pid ? pid : ::getpid()));
+
+		DIR* task_dir = ::opendir(path);
+		if (!task_dir) return false;
+
+		while (struct dirent* entry = ::readdir(task_dir)) {
+			if (entry->d_name[0] < '0' || entry->d_name[0] > '9') continue;
+			open_group((pid_t)std::atoi(entry->d_name), -1);
+		}
+
+		::closedir(task_dir);
+		return !groups.empty();
+	}
+
+	void close_groups() {
+		for (std::size_t i = 0; i < groups.size(); i++) {
+			for (int event = 0; event < eHardwareEventCount; event++) {
+				if (groups[i].EventFds[event] >= 0) ::close(groups[i].EventFds[event]);
+			}
+		}
+
+		groups.clear();
+		available_events = 0;
+	}
+
+	/*
+		    read()      totals
+	*/
+	bool read_group(EventGroupStruct& group, double* totals, double& running_fraction) {
+		const std::size_t buffer_bytes = read_buffer.size() * sizeof(boost::uint64_t);
+		ssize_t read_size = ::read(group.LeaderFd, &read_buffer[0], buffer_bytes);
+		if (read_size < (ssize_t)(read_header_size * sizeof(boost::uint64_t))) return false;
+
+		const boost::uint64_t event_count = read_buffer[0];
+		const boost::uint64_t time_enabled = read_buffer[1];
+		const boost::uint64_t time_running = read_buffer[2];
+		const boost::uint64_t delta_enabled = time_enabled - group.PrevTimeEnabled;
+		const boost::uint64_t delta_running = time_running - group.PrevTimeRunning;
+
+		double scale = 1.0;
+		if (delta_running && delta_running < delta_enabled) scale = (double)delta_enabled / (double)delta_running;
+		if (delta_enabled) running_fraction = (double)delta_running / (double)delta_enabled;
+		if (!delta_running) scale = 0.0;
+
+		for (boost::uint64_t i = 0; i < event_count && read_header_size + i * 2 + 1 < read_buffer.size(); i++) {
+			const boost::uint64_t value = read_buffer[read_header_size + i * 2];
+			const boost::uint64_t id = read_buffer[read_header_size + i * 2 + 1];
+
+			for (int event = 0; event < eHardwareEventCount; event++) {
+				if (group.EventFds[event] < 0 || group.EventIds[event] != id) continue;
+
+				totals[event] += (double)(value - group.PrevValues[event]) * scale;
+				group.PrevValues[event] = value;
+				break;
+			}
+		}
+
+		group.PrevTimeEnabled = time_enabled;
+		group.PrevTimeRunning = time_running;
+		return true;
+	}
+
+public:
+	hw_counter() : available_events(0) {
+		read_buffer.resize(read_header_size + eHardwareEventCount * 2);
+		open_group(0, -1);
+	}
+
+	/*
+		id - TID  eThread, PID  eProcess,    eCpu.
+		  eProcess   ,    
+		,  eCpu   CAP_PERFMON  perf_event_paranoid <= 0.
+	*/
+	explicit hw_counter(EHardwareCounterScope scope, int id = 0) : available_events(0) {
+		read_buffer.resize(read_header_size + eHardwareEventCount * 2);
+
+		switch (scope) {
+		case eThisThread: open_group(0, -1); break;
+		case eThread: open_group((pid_t)id, -1); break;
+		case eProcess: open_process((pid_t)id); break;
+		case eCpu: open_group(-1, id); break;
+		}
+	}
+
+	~hw_counter() {
+		close_groups();
+	}
+
+	bool is_open() const {
+		return !groups.empty();
+	}
+
+	unsigned long get_available_events() const {
+		return available_events;
+	}
+
+	/*
+		       (  )
+	*/
+	bool get_counters(HardwareCountersStruct& counters) {
+		double totals[eHardwareEventCount] = {};
+		double running_fraction_sum = 0.0;
+		std::size_t read_groups = 0;
+
+		for (std::size_t i = 0; i < groups.size(); i++) {
+			double running_fraction = 1.0;
+			if (!read_group(groups[i], totals, running_fraction)) continue;
+
+			running_fraction_sum += running_fraction;
+			read_groups++;
+		}
+
+		if (!read_groups) return false;
+
+		counters.Cycles = (unsigned long long)totals[eCycles];
+		counters.Instructions = (unsigned long long)totals[eInstructions];
+		counters.CacheMisses = (unsigned long long)totals[eCacheMisses];
+		counters.BranchMisses = (unsigned long long)totals[eBranchMisses];
+		counters.ContextSwitches = (unsigned long long)totals[eContextSwitches];
+		counters.InstructionsPerCycle = counters.Cycles ? (float)(totals[eInstructions] / totals[eCycles]) : 0.f;
+		counters.RunningFraction = (float)(running_fraction_sum / read_groups);
+		counters.AvailableEvents = available_events;
+		return true;
+	}
+};
+
+}}}}
+#endif
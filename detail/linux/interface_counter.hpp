@@ -0,0 +1,333 @@
+#ifndef BOOST_INTERFACE_COUNTER_LINUX_HPP
+#define BOOST_INTERFACE_COUNTER_LINUX_HPP
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <cstdlib>
+#include <cstring>
+#include <errno.h>
+#include <unistd.h>
+#include <net/if.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/if_link.h>
+#include <boost/cstdint.hpp>
+#include <boost/chrono.hpp>
+#include <boost/container/vector.hpp>
+#include "proc_file.hpp"
+
+namespace boost { namespace perfomance { namespace detail { namespace linux_ {
+
+typedef struct {
+	unsigned long Index;					// ifindex
+	char Name[IFNAMSIZ];
+	double ReceiveBytesPerSecond;
+	double TransmitBytesPerSecond;
+	double ReceivePacketsPerSecond;
+	double TransmitPacketsPerSecond;
+	double ReceiveDropsPerSecond;
+	double TransmitDropsPerSecond;
+	double ReceiveErrorsPerSecond;
+	double TransmitErrorsPerSecond;
+} InterfaceStatisticsStruct;
+
+/*
+	      .    
+	RTM_GETLINK ( IFLA_STATS64),   netlink  -  /proc/net/dev.
+	    ,  ifindex,    
+	       .
+*/
+class interface_counter {
+private:
+	enum EInterfaceCounter {
+		eReceiveBytes,
+		eTransmitBytes,
+		eReceivePackets,
+		eTransmitPackets,
+		eReceiveDrops,
+		eTransmitDrops,
+		eReceiveErrors,
+		eTransmitErrors,
+		eInterfaceCounterCount
+	};
+
+	typedef struct {
+		nlmsghdr Header;
+		ifinfomsg Request;
+	} LinkRequestStruct;
+
+	typedef struct {
+		unsigned long long Counters[eInterfaceCounterCount];
+		boost::uint64_t Timestamp;
+		char Name[IFNAMSIZ];					//   ifindex    /proc/net/dev
+		unsigned long Generation;
+	} InterfaceStateStruct;
+
+	int netlink_fd;
+	boost::uint32_t sequence;
+	boost::container::vector<char> receive_buffer;
+	proc_file net_dev_file;
+
+	/*
+		       ifindex,   
+	*/
+	boost::container::vector<InterfaceStateStruct> interface_states;
+	boost::uint64_t timestamp;
+
+	/*
+		ifindex     /proc/net/dev   . 
+		       ,   
+		      ,  if_nametoindex (  ioctl)
+		    .
+	*/
+	boost::container::vector<unsigned long> net_dev_indexes;
+	unsigned long net_dev_generation;
+
+	interface_counter(const interface_counter&);
+	interface_counter& operator=(const interface_counter&);
+
+	static double calculate_rate(unsigned long long current, unsigned long long previous, boost::uint64_t elapsed) {
+		if (current <= previous || !elapsed) return 0.0;
+		return (double)(current - previous) * 1e9 / (double)elapsed;
+	}
+
+	void append_interface(boost::container::vector<InterfaceStatisticsStruct>& statistics, unsigned long index,
+		const char* name, std::size_t name_size, const unsigned long long* counters) {
+		if (index >= interface_states.size()) interface_states.resize(index * 2 + 1, InterfaceStateStruct());
+
+		InterfaceStateStruct& state = interface_states[index];
+		boost::uint64_t elapsed = state.Timestamp ? timestamp - state.Timestamp : 0;
+
+		InterfaceStatisticsStruct interface_statistics;
+		interface_statistics.Index = index;
+
+		if (name_size >= IFNAMSIZ) name_size = IFNAMSIZ - 1;
+		std::memcpy(interface_statistics.Name, name, name_size);
+		interface_statistics.Name[name_size] = '\0';
+
+		double rates[eInterfaceCounterCount];
+		for (std::size_t i = 0; i < eInterfaceCounterCount; i++) {
+			rates[i] = calculate_rate(counters[i], state.Counters[i], elapsed);
+			state.Counters[i] = counters[i];
+		}
+
+		interface_statistics.ReceiveBytesPerSecond = rates[eReceiveBytes];
+		interface_statistics.TransmitBytesPerSecond = rates[eTransmitBytes];
+		interface_statistics.ReceivePacketsPerSecond = rates[eReceivePackets];
+		interface_statistics.TransmitPacketsPerSecond = rates[eTransmitPackets];
+		interface_statistics.ReceiveDropsPerSecond = rates[eReceiveDrops];
+		interface_statistics.TransmitDropsPerSecond = rates[eTransmitDrops];
+		interface_statistics.ReceiveErrorsPerSecond = rates[eReceiveErrors];
+		interface_statistics.TransmitErrorsPerSecond = rates[eTransmitErrors];
+
+		std::memcpy(state.Name, interface_statistics.Name, name_size + 1);
+		state.Timestamp = timestamp;
+		statistics.push_back(interface_statistics);
+	}
+
+	bool send_link_dump() {
+		LinkRequestStruct request;
+		std::memset(&request, 0, sizeof(request));
+
+		request.Header.nlmsg_len = sizeof(request);
+		request.Header.nlmsg_type = RTM_GETLINK;
+		request.Header.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+		request.Header.nlmsg_seq = ++sequence;
+		request.Request.ifi_family = AF_UNSPEC;
+
+		for (;;) {
+			ssize_t ret_value = ::send(netlink_fd, &request, sizeof(request), 0);
+			if (ret_value == (ssize_t)sizeof(request)) return true;
+			if (ret_value < 0 && errno == EINTR) continue;
+			return false;
+		}
+	}
+
+	void parse_link(boost::container::vector<InterfaceStatisticsStruct>& statistics, const nlmsghdr* header) {
+		const ifinfomsg* link = (const ifinfomsg*)NLMSG_DATA(header);
+		int attributes_size = (int)(header->nlmsg_len - NLMSG_LENGTH(sizeof(ifinfomsg)));
+		const rtattr* attribute = IFLA_RTA(link);
+
+		const char* name = NULL;
+		std::size_t name_size = 0;
+		rtnl_link_stats64 link_stats;
+		bool has_stats = false;
+
+		for (; RTA_OK(attribute, attributes_size); attribute = RTA_NEXT(attribute, attributes_size)) {
+			if (attribute->rta_type == IFLA_IFNAME) {
+				name = (const char*)RTA_DATA(attribute);
+				name_size = strnlen(name, RTA_PAYLOAD(attribute));
+			} else if (attribute->rta_type == IFLA_STATS64) {
+				std::size_t stats_size = RTA_PAYLOAD(attribute);
+				std::memset(&link_stats, 0, sizeof(link_stats));
+				std::memcpy(&link_stats, RTA_DATA(attribute), stats_size < sizeof(link_stats) ? stats_size : sizeof(link_stats));
+				has_stats = true;
+			}
+		}
+
+		if (!name || !has_stats || link->ifi_index <= 0) return;
+
+		unsigned long long counters[eInterfaceCounterCount];
+		counters[eReceiveBytes] = link_stats.rx_bytes;
+		counters[eTransmitBytes] = link_stats.tx_bytes;
+		counters[eReceivePackets] = link_stats.rx_packets;
+		counters[eTransmitPackets] = link_stats.tx_packets;
+		counters[eReceiveDrops] = link_stats.rx_dropped;
+		counters[eTransmitDrops] = link_stats.tx_dropped;
+		counters[eReceiveErrors] = link_stats.rx_errors;
+		counters[eTransmitErrors] = link_stats.tx_errors;
+
+		append_interface(statistics, (unsigned long)link->ifi_index, name, name_size, counters);
+	}
+
+	bool receive_link_dump(boost::container::vector<InterfaceStatisticsStruct>& statistics) {
+		for (;;) {
+			ssize_t read_size = ::recv(netlink_fd, &receive_buffer[0], receive_buffer.size(), 0);
+			if (read_size < 0) {
+				if (errno == EINTR) continue;
+				return false;
+			}
+
+			const nlmsghdr* header = (const nlmsghdr*)&receive_buffer[0];
+			int remaining = (int)read_size;
+
+			for (; NLMSG_OK(header, remaining); header = NLMSG_NEXT(header, remaining)) {
+				if (header->nlmsg_seq != sequence) continue;
+				if (header->nlmsg_type == NLMSG_DONE) return true;
+				if (header->nlmsg_type == NLMSG_ERROR) return false;
+				if (header->nlmsg_type != RTM_NEWLINK || header->nlmsg_len < NLMSG_LENGTH(sizeof(ifinfomsg))) continue;
+
+				parse_link(statistics, header);
+			}
+		}
+	}
+
+	bool is_cached_name(unsigned long index, const char* name) const {
+		return index && index < interface_states.size() && interface_states[index].Generation == net_dev_generation - 1
+			&& !std::strcmp(interface_states[index].Name, name);
+	}
+
+	/*
+		ifindex    /proc/net/dev:       
+		,     ,    if_nametoindex. ,
+		     ,  ,     
+		     ifindex.
+	*/
+	unsigned long resolve_net_dev_index(std::size_t position, const char* name) {
+		if (position < net_dev_indexes.size() && is_cached_name(net_dev_indexes[position], name)) return net_dev_indexes[position];
+
+		for (std::size_t i = 0; i < net_dev_indexes.size(); i++) {
+			if (is_cached_name(net_dev_indexes[i], name)) return net_dev_indexes[i];
+		}
+
+		return ::if_nametoindex(name);
+	}
+
+	/*
+		 : /proc/net/dev,   ,  ": 16 ".
+		  - rx bytes, packets, errs, drop (1-4)  tx bytes, packets, errs, drop (9-12).
+	*/
+	bool read_net_dev(boost::container::vector<InterfaceStatisticsStruct>& statistics) {
+		if (!net_dev_file.is_open() || !net_dev_file.read()) return false;
+
+		text_scanner scanner(net_dev_file);
+		scanner.next_line();
+		scanner.next_line();
+
+		std::size_t position = 0;
+		net_dev_generation++;
+
+		while (!scanner.eof()) {
+			scanner.skip_spaces();
+			const char* name = scanner.cur;
+			while (scanner.cur < scanner.end && *scanner.cur != ':' && *scanner.cur != '\n') scanner.cur++;
+			if (scanner.at_line_end()) {
+				scanner.next_line();
+				continue;
+			}
+
+			std::size_t name_size = (std::size_t)(scanner.cur - name);
+			scanner.cur++;
+
+			unsigned long long fields[16];
+			bool complete = true;
+			for (std::size_t i = 0; i < 16 && complete; i++) {
+				complete = scanner.parse(fields[i]);
+			}
+
+			scanner.next_line();
+			if (!complete || name_size >= IFNAMSIZ) continue;
+
+			char interface_name[IFNAMSIZ];
+			std::memcpy(interface_name, name, name_size);
+			interface_name[name_size] = '\0';
+
+			unsigned long index = resolve_net_dev_index(position, interface_name);
+			if (!index) continue;
+
+			unsigned long long counters[eInterfaceCounterCount];
+			counters[eReceiveBytes] = fields[0];
+			counters[eReceivePackets] = fields[1];
+			counters[eReceiveErrors] = fields[2];
+			counters[eReceiveDrops] = fields[3];
+			counters[eTransmitBytes] = fields[8];
+			counters[eTransmitPackets] = fields[9];
+			counters[eTransmitErrors] = fields[10];
+			counters[eTransmitDrops] = fields[11];
+
+			append_interface(statistics, index, name, name_size, counters);
+			interface_states[index].Generation = net_dev_generation;
+
+			if (position < net_dev_indexes.size()) {
+				net_dev_indexes[position] = index;
+			} else {
+				net_dev_indexes.push_back(index);
+			}
+
+			position++;
+		}
+
+		net_dev_indexes.resize(position);
+		return true;
+	}
+
+public:
+	interface_counter() : netlink_fd(-1), sequence(0), timestamp(0), net_dev_generation(1) {
+		netlink_fd = ::socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+		if (netlink_fd >= 0) {
+			receive_buffer.resize(65536);
+		} else {
+			net_dev_file.open("/proc/net/dev");
+		}
+
+		interface_states.resize(64, InterfaceStateStruct());
+	}
+
+	~interface_counter() {
+		if (netlink_fd >= 0) ::close(netlink_fd);
+	}
+
+	/*
+		      .   
+		(     )   .
+	*/
+	bool get_interface_statistics(boost::container::vector<InterfaceStatisticsStruct>& statistics) {
+		statistics.clear();
+		timestamp = (boost::uint64_t)boost::chrono::duration_cast<boost::chrono::nanoseconds>(
+			boost::chrono::steady_clock::now().time_since_epoch()).count();
+
+		if (netlink_fd >= 0) {
+			if (send_link_dump() && receive_link_dump(statistics)) return true;
+			statistics.clear();
+		}
+
+		if (!net_dev_file.is_open()) net_dev_file.open("/proc/net/dev");
+		return read_net_dev(statistics);
+	}
+};
+
+}}}}
+#endif
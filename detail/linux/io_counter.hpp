@@ -0,0 +1,396 @@
+#ifndef BOOST_IO_COUNTER_LINUX_HPP
+#define BOOST_IO_COUNTER_LINUX_HPP
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <boost/cstdint.hpp>
+#include <boost/container/vector.hpp>
+#include "../open_hash_map.hpp"
+#include "descriptor_cache.hpp"
+#include "proc_file.hpp"
+
+namespace boost { namespace perfomance { namespace detail { namespace linux_ {
+
+/*
+	  /proc/diskstats,   -   
+*/
+typedef struct {
+	unsigned long Major;
+	unsigned long Minor;
+	char Name[32];
+	double ReadsPerSecond;				//  
+	double WritesPerSecond;
+	double ReadBytesPerSecond;
+	double WriteBytesPerSecond;
+	double ReadLatency;					//   , 
+	double WriteLatency;
+	double FlushesPerSecond;			//    (fsync), Linux 5.5+
+	double FlushLatency;
+	float Utilization;					//  ,       
+	float AverageQueueSize;				//     
+	unsigned long InFlight;				//      
+} DiskStatisticsStruct;
+
+/*
+	-   /proc/<pid>/io,  -      
+*/
+typedef struct {
+	double ReadBytesPerSecond;			//    (read_bytes)
+	double WriteBytesPerSecond;			//    (write_bytes)
+	double ReadCharsPerSecond;			//  read,    (rchar)
+	double WriteCharsPerSecond;
+	double ReadCallsPerSecond;			//    (syscr)
+	double WriteCallsPerSecond;
+	unsigned long long ReadBytes;		//    
+	unsigned long long WriteBytes;
+	unsigned long long CancelledWriteBytes;	//  ,    (truncate)
+} ProcessIoStruct;
+
+/*
+	-   . /proc/diskstats    
+	 pread,     /proc/<pid>/io,  
+	   -      PID,    
+	   .
+
+	 /proc/<pid>/io      ,   ptrace.
+*/
+class io_counter {
+private:
+	enum EDiskField {
+		eReads = 0,
+		eReadsMerged,
+		eSectorsRead,
+		eReadTime,
+		eWrites,
+		eWritesMerged,
+		eSectorsWritten,
+		eWriteTime,
+		eInFlight,
+		eIoTime,
+		eWeightedIoTime,
+		eDiscards,
+		eDiscardsMerged,
+		eSectorsDiscarded,
+		eDiscardTime,
+		eFlushes,
+		eFlushTime,
+		eDiskFieldCount
+	};
+
+	enum EProcessField {
+		eReadChars = 0,
+		eWriteChars,
+		eReadCalls,
+		eWriteCalls,
+		eReadBytes,
+		eWriteBytes,
+		eCancelledWriteBytes,
+		eProcessFieldCount
+	};
+
+	typedef struct {
+		unsigned long Generation;
+		unsigned long long Fields[eDiskFieldCount];
+	} DiskStateStruct;
+
+	typedef struct {
+		int Fd;
+		unsigned long Generation;			//   ,    PID
+		boost::uint64_t Timestamp;
+		unsigned long long Fields[eProcessFieldCount];
+	} ProcessStateStruct;
+
+	int proc_fd;
+	proc_file diskstats_file;
+	open_hash_map<DiskStateStruct> disks;
+	unsigned long disk_generation;
+	boost::uint64_t disk_timestamp;
+
+	descriptor_cache descriptors;
+	open_hash_map<ProcessStateStruct> processes;
+	unsigned long process_generation;
+	char io_buffer[512];
+
+	io_counter(const io_counter&);
+	io_counter& operator=(const io_counter&);
+
+	struct missing_disk {
+		unsigned long current_generation;
+
+		explicit missing_disk(unsigned long generation_value) : current_generation(generation_value) {}
+
+		bool operator()(boost::uint64_t, const DiskStateStruct& disk) {
+			return disk.Generation != current_generation;
+		}
+	};
+
+	struct unrequested_process {
+		unsigned long current_generation;
+		descriptor_cache& descriptors;
+
+		unrequested_process(unsigned long generation_value, descriptor_cache& cache) : current_generation(generation_value), descriptors(cache) {}
+
+		bool operator()(boost::uint64_t, ProcessStateStruct& process) {
+			if (process.Generation == current_generation) return false;
+			descriptors.release(process.Fd);
+			return true;
+		}
+	};
+
+	struct close_process {
+		descriptor_cache& descriptors;
+
+		explicit close_process(descriptor_cache& cache) : descriptors(cache) {}
+
+		void operator()(boost::uint64_t, ProcessStateStruct& process) {
+			descriptors.release(process.Fd);
+		}
+	};
+
+	static boost::uint64_t steady_nanoseconds() {
+		timespec now;
+		::clock_gettime(CLOCK_MONOTONIC, &now);
+		return (boost::uint64_t)now.tv_sec * 1000000000ull + (boost::uint64_t)now.tv_nsec;
+	}
+
+	static double rate(unsigned long long current, unsigned long long previous, double elapsed_seconds) {
+		return elapsed_seconds > 0 && current > previous ? (double)(current - previous) / elapsed_seconds : 0.0;
+	}
+
+	static double latency(unsigned long long time, unsigned long long previous_time, unsigned long long count, unsigned long long previous_count) {
+		return count > previous_count && time >= previous_time ? (double)(time - previous_time) / (double)(count - previous_count) : 0.0;
+	}
+
+	/*
+		"major minor name"   11 ( 4.18)  17 ( 5.5) .   diskstats
+		  512    .
+	*/
+	void parse_disk_line(text_scanner& scanner, double elapsed_seconds, boost::container::vector<DiskStatisticsStruct>& statistics) {
+		unsigned long long major = 0;
+		unsigned long long minor = 0;
+		if (!scanner.parse(major) || !scanner.parse(minor)) return;
+
+		scanner.skip_spaces();
+		const char* name = scanner.cur;
+		scanner.skip_token();
+		std::size_t name_size = (std::size_t)(scanner.cur - name);
+
+		unsigned long long fields[eDiskFieldCount] = {};
+		for (int i = 0; i < eDiskFieldCount && !scanner.at_line_end(); i++) {
+			if (!scanner.parse(fields[i])) return;
+		}
+
+		bool inserted = false;
+		DiskStateStruct& disk = disks.insert((major << 32) | minor, inserted);
+		disk.Generation = disk_generation;
+		if (inserted) std::memcpy(disk.Fields, fields, sizeof(fields));
+
+		const unsigned long long* previous = disk.Fields;
+		double elapsed_milliseconds = elapsed_seconds * 1e3;
+
+		statistics.push_back(DiskStatisticsStruct());
+		DiskStatisticsStruct& device = statistics.back();
+		device.Major = (unsigned long)major;
+		device.Minor = (unsigned long)minor;
+		if (name_size >= sizeof(device.Name)) name_size = sizeof(device.Name) - 1;
+		std::memcpy(device.Name, name, name_size);
+		device.Name[name_size] = '\0';
+
+		device.ReadsPerSecond = rate(fields[eReads], previous[eReads], elapsed_seconds);
+		device.WritesPerSecond = rate(fields[eWrites], previous[eWrites], elapsed_seconds);
+		device.ReadBytesPerSecond = rate(fields[eSectorsRead], previous[eSectorsRead], elapsed_seconds) * 512;
+		device.WriteBytesPerSecond = rate(fields[eSectorsWritten], previous[eSectorsWritten], elapsed_seconds) * 512;
+		device.ReadLatency = latency(fields[eReadTime], previous[eReadTime], fields[eReads], previous[eReads]);
+		device.WriteLatency = latency(fields[eWriteTime], previous[eWriteTime], fields[eWrites], previous[eWrites]);
+		device.FlushesPerSecond = rate(fields[eFlushes], previous[eFlushes], elapsed_seconds);
+		device.FlushLatency = latency(fields[eFlushTime], previous[eFlushTime], fields[eFlushes], previous[eFlushes]);
+		device.Utilization = elapsed_milliseconds > 0 && fields[eIoTime] > previous[eIoTime] ? (float)((double)(fields[eIoTime] - previous[eIoTime]) / elapsed_milliseconds) : 0.f;
+		device.AverageQueueSize = elapsed_milliseconds > 0 && fields[eWeightedIoTime] > previous[eWeightedIoTime] ? (float)((double)(fields[eWeightedIoTime] - previous[eWeightedIoTime]) / elapsed_milliseconds) : 0.f;
+		device.InFlight = (unsigned long)fields[eInFlight];
+
+		if (device.Utilization > 1.f) device.Utilization = 1.f;
+		std::memcpy(disk.Fields, fields, sizeof(fields));
+	}
+
+	static bool parse_process_io(const char* data, std::size_t size, unsigned long long* fields) {
+		static const char* const names[] = { "rchar:", "wchar:", "syscr:", "syscw:", "read_bytes:", "write_bytes:", "cancelled_write_bytes:" };
+		static const std::size_t name_sizes[] = { 6, 6, 6, 6, 11, 12, 22 };
+
+		text_scanner scanner(data, data + size);
+		for (int i = 0; i < eProcessFieldCount; i++) {
+			if (!scanner.find_line(names[i], name_sizes[i]) || !scanner.parse(fields[i])) return false;
+		}
+
+		return true;
+	}
+
+	/*
+		  ( ,    )  
+		.     ,   
+		, PID        .
+	*/
+	bool read_process_io(int process_id, ProcessIoStruct& process_io) {
+		bool inserted = false;
+		ProcessStateStruct& process = processes.insert((boost::uint64_t)process_id, inserted);
+		process.Generation = process_generation;
+		if (inserted) process.Fd = -1;
+
+		bool had_descriptor = process.Fd >= 0;
+		ssize_t read_size = descriptors.read(process.Fd, io_buffer, sizeof(io_buffer));
+		if (read_size < 0) {
+			char path[32];
+			if (process_id) {
+				std::snprintf(path, sizeof(path), "%d/io", process_id);
+			} else {
+				std::strcpy(path, "self/io");
+			}
+
+			read_size = descriptors.open_read(proc_fd, path, process.Fd, io_buffer, sizeof(io_buffer));
+			if (had_descriptor) inserted = true;
+		}
+
+		unsigned long long fields[eProcessFieldCount];
+		if (read_size <= 0 || !parse_process_io(io_buffer, (std::size_t)read_size, fields)) {
+			descriptors.release(process.Fd);
+			processes.erase((boost::uint64_t)process_id);
+			return false;
+		}
+
+		boost::uint64_t timestamp = steady_nanoseconds();
+		if (inserted) {
+			std::memcpy(process.Fields, fields, sizeof(fields));
+			process.Timestamp = timestamp;
+		}
+
+		double elapsed_seconds = timestamp > process.Timestamp ? (double)(timestamp - process.Timestamp) * 1e-9 : 0.0;
+		process_io.ReadBytesPerSecond = rate(fields[eReadBytes], process.Fields[eReadBytes], elapsed_seconds);
+		process_io.WriteBytesPerSecond = rate(fields[eWriteBytes], process.Fields[eWriteBytes], elapsed_seconds);
+		process_io.ReadCharsPerSecond = rate(fields[eReadChars], process.Fields[eReadChars], elapsed_seconds);
+		process_io.WriteCharsPerSecond = rate(fields[eWriteChars], process.Fields[eWriteChars], elapsed_seconds);
+		process_io.ReadCallsPerSecond = rate(fields[eReadCalls], process.Fields[eReadCalls], elapsed_seconds);
+		process_io.WriteCallsPerSecond = rate(fields[eWriteCalls], process.Fields[eWriteCalls], elapsed_seconds);
+		process_io.ReadBytes = fields[eReadBytes];
+		process_io.WriteBytes = fields[eWriteBytes];
+		process_io.CancelledWriteBytes = fields[eCancelledWriteBytes];
+
+		std::memcpy(process.Fields, fields, sizeof(fields));
+		process.Timestamp = timestamp;
+		return true;
+	}
+
+	void open(const char* diskstats_path) {
+		proc_fd = ::open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+		diskstats_file.open(diskstats_path, 8192);
+	}
+
+public:
+	io_counter() : proc_fd(-1), disk_generation(0), disk_timestamp(0), process_generation(0) {
+		open("/proc/diskstats");
+	}
+
+	/*
+		      /proc/diskstats,   
+		  .  -   /proc.
+	*/
+	explicit io_counter(const char* diskstats_path) : proc_fd(-1), disk_generation(0), disk_timestamp(0), process_generation(0) {
+		open(diskstats_path);
+	}
+
+	~io_counter() {
+		close_process functor(descriptors);
+		processes.for_each(functor);
+		if (proc_fd >= 0) ::close(proc_fd);
+	}
+
+	/*
+		   ,  loop  ram.      .
+	*/
+	bool get_disk_statistics(boost::container::vector<DiskStatisticsStruct>& statistics) {
+		if (!diskstats_file.read()) return false;
+
+		boost::uint64_t timestamp = steady_nanoseconds();
+		double elapsed_seconds = disk_timestamp && timestamp > disk_timestamp ? (double)(timestamp - disk_timestamp) * 1e-9 : 0.0;
+
+		disk_generation++;
+		disk_timestamp = timestamp;
+		statistics.clear();
+
+		text_scanner scanner(diskstats_file);
+		while (!scanner.eof()) {
+			parse_disk_line(scanner, elapsed_seconds, statistics);
+			scanner.next_line();
+		}
+
+		if (statistics.size() != disks.size()) {
+			missing_disk predicate(disk_generation);
+			disks.erase_if(predicate);
+		}
+
+		return true;
+	}
+
+	/*
+		process_id == 0 -  .      .
+		  (  ) ,       
+		 forget,       PID   
+		   .
+	*/
+	bool get_process_io(int process_id, ProcessIoStruct& process_io) {
+		if (proc_fd < 0) return false;
+		return read_process_io(process_id, process_io);
+	}
+
+	/*
+		 .  ,    ,  ,
+		   false. ,     , 
+		  ,   memory_counter.
+	*/
+	bool get_process_io(const int* process_ids, std::size_t process_count, ProcessIoStruct* process_io) {
+		if (proc_fd < 0) return false;
+
+		bool ret_value = true;
+		process_generation++;
+		for (std::size_t i = 0; i < process_count; i++) {
+			if (!read_process_io(process_ids[i], process_io[i])) {
+				std::memset(&process_io[i], 0, sizeof(ProcessIoStruct));
+				ret_value = false;
+			}
+		}
+
+		if (processes.size() > process_count) {
+			unrequested_process predicate(process_generation, descriptors);
+			processes.erase_if(predicate);
+		}
+
+		return ret_value;
+	}
+
+	/*
+		      
+	*/
+	void forget(int process_id) {
+		ProcessStateStruct* process = processes.find((boost::uint64_t)process_id);
+		if (!process) return;
+
+		descriptors.release(process->Fd);
+		processes.erase((boost::uint64_t)process_id);
+	}
+
+	/*
+		 ,    
+	*/
+	std::size_t get_process_count() const {
+		return processes.size();
+	}
+};
+
+}}}}
+#endif
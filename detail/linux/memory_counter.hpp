@@ -0,0 +1,242 @@
+#ifndef BOOST_MEMORY_COUNTER_LINUX_HPP
+#define BOOST_MEMORY_COUNTER_LINUX_HPP
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <cstdlib>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include <boost/cstdint.hpp>
+#include <boost/container/vector.hpp>
+#include "../open_hash_map.hpp"
+#include "descriptor_cache.hpp"
+#include "proc_file.hpp"
+
+namespace boost { namespace perfomance { namespace detail { namespace linux_ {
+
+class memory_counter {
+private:
+	/*
+		 /proc/<pid>/statm ( descriptor_cache)    
+		,      . ,  
+		, .
+	*/
+	typedef struct {
+		int Fd;
+		unsigned long Generation;
+	} CachedStatmStruct;
+
+	unsigned long long page_size;
+	unsigned long batch_generation;
+
+	proc_file meminfo_file;
+	proc_file self_statm_file;
+	proc_file self_status_file;
+
+	int proc_fd;
+	descriptor_cache descriptors;
+	open_hash_map<CachedStatmStruct> statm_files;
+	char statm_buffer[128];
+
+	memory_counter(const memory_counter&);
+	memory_counter& operator=(const memory_counter&);
+
+	struct unrequested_process {
+		unsigned long current_generation;
+		descriptor_cache& descriptors;
+
+		unrequested_process(unsigned long generation_value, descriptor_cache& cache) : current_generation(generation_value), descriptors(cache) {}
+
+		bool operator()(boost::uint64_t, CachedStatmStruct& cached) {
+			if (cached.Generation == current_generation) return false;
+			descriptors.release(cached.Fd);
+			return true;
+		}
+	};
+
+	struct close_process {
+		descriptor_cache& descriptors;
+
+		explicit close_process(descriptor_cache& cache) : descriptors(cache) {}
+
+		void operator()(boost::uint64_t, CachedStatmStruct& cached) {
+			descriptors.release(cached.Fd);
+		}
+	};
+
+	static bool find_kb_value(const proc_file& file, const char* name, std::size_t name_size, unsigned long long& value) {
+		text_scanner scanner(file);
+		if (!scanner.find_line(name, name_size) || !scanner.parse(value)) return false;
+		value *= 1024;
+		return true;
+	}
+
+	/*
+		  statm -     ,  
+		WorkingSetSize  Windows
+	*/
+	bool parse_statm_resident(const proc_file& file, unsigned long long& mem_load) const {
+		return parse_statm_resident(text_scanner(file), mem_load);
+	}
+
+	bool parse_statm_resident(text_scanner scanner, unsigned long long& mem_load) const {
+		unsigned long long total_pages = 0;
+		unsigned long long resident_pages = 0;
+
+		if (!scanner.parse(total_pages) || !scanner.parse(resident_pages)) return false;
+		mem_load = resident_pages * page_size;
+		return true;
+	}
+
+	static void format_pid_path(char* path, std::size_t path_size, int process_id, const char* file_name) {
+		std::snprintf(path, path_size, "/proc/%d/%s", process_id, file_name);
+	}
+
+	/*
+		     .   
+		pread     ESRCH,    PID   
+		,         .  
+		  ,    open/pread/close.
+	*/
+	bool read_cached_statm(int process_id, unsigned long long& mem_load) {
+		bool inserted = false;
+		CachedStatmStruct& cached = statm_files.insert((boost::uint64_t)process_id, inserted);
+		cached.Generation = batch_generation;
+		if (inserted) cached.Fd = -1;
+
+		ssize_t read_size = descriptors.read(cached.Fd, statm_buffer, sizeof(statm_buffer));
+		if (read_size < 0) {
+			char path[32];
+			std::snprintf(path, sizeof(path), "%d/statm", process_id);
+			read_size = descriptors.open_read(proc_fd, path, cached.Fd, statm_buffer, sizeof(statm_buffer));
+		}
+
+		if (read_size > 0 && parse_statm_resident(text_scanner(statm_buffer, statm_buffer + read_size), mem_load)) return true;
+
+		descriptors.release(cached.Fd);
+		statm_files.erase((boost::uint64_t)process_id);
+		return false;
+	}
+
+public:
+	memory_counter() : batch_generation(0), proc_fd(-1) {
+		long system_page_size = ::sysconf(_SC_PAGESIZE);
+		page_size = system_page_size > 0 ? (unsigned long long)system_page_size : 4096;
+
+		meminfo_file.open("/proc/meminfo", 8192);
+		self_statm_file.open("/proc/self/statm", 128);
+		self_status_file.open("/proc/self/status", 4096);
+		proc_fd = ::open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	}
+
+	~memory_counter() {
+		close_process functor(descriptors);
+		statm_files.for_each(functor);
+		if (proc_fd >= 0) ::close(proc_fd);
+	}
+
+	/*
+		     
+	*/
+	bool get_swap_load(unsigned long long& swap_load) {
+		unsigned long long swap_total = 0;
+		unsigned long long swap_free = 0;
+
+		if (!meminfo_file.read()) return false;
+		if (!find_kb_value(meminfo_file, "SwapTotal:", 10, swap_total) || !find_kb_value(meminfo_file, "SwapFree:", 9, swap_free)) return false;
+		swap_load = swap_total - swap_free;
+		return true;
+	}
+
+	/*
+		 ullTotalVirtual - ullAvailVirtual  Linux -   (committed)
+		    
+	*/
+	bool get_vmemory_load(unsigned long long& mem_load) {
+		if (!meminfo_file.read()) return false;
+		return find_kb_value(meminfo_file, "Committed_AS:", 13, mem_load);
+	}
+
+	/*
+		get_swap_load  get_vmemory_load    /proc/meminfo:  
+		   ,        
+	*/
+	bool get_system_memory_load(unsigned long long& swap_load, unsigned long long& vmemory_load) {
+		unsigned long long swap_total = 0;
+		unsigned long long swap_free = 0;
+
+		if (!meminfo_file.read()) return false;
+		if (!find_kb_value(meminfo_file, "SwapTotal:", 10, swap_total) || !find_kb_value(meminfo_file, "SwapFree:", 9, swap_free)) return false;
+		if (!find_kb_value(meminfo_file, "Committed_AS:", 13, vmemory_load)) return false;
+		swap_load = swap_total - swap_free;
+		return true;
+	}
+
+	/*
+		      
+	*/
+	bool get_process_swap_load(unsigned long long& swap_load) {
+		if (!self_status_file.read()) return false;
+		return find_kb_value(self_status_file, "VmSwap:", 7, swap_load);
+	}
+
+	bool get_process_vmemory_load(unsigned long long& mem_load) {
+		if (!self_statm_file.read_head()) return false;
+		return parse_statm_resident(self_statm_file, mem_load);
+	}
+
+	/*
+		       
+	*/
+	bool get_process_swap_load(int process_id, unsigned long long& swap_load) {
+		char path[64];
+		format_pid_path(path, sizeof(path), process_id, "status");
+
+		proc_file status_file(path, 4096);
+		if (!status_file.read()) return false;
+		return find_kb_value(status_file, "VmSwap:", 7, swap_load);
+	}
+
+	bool get_process_vmemory_load(int process_id, unsigned long long& mem_load) {
+		char path[64];
+		format_pid_path(path, sizeof(path), process_id, "statm");
+
+		proc_file statm_file(path, 128);
+		if (!statm_file.read_head()) return false;
+		return parse_statm_resident(statm_file, mem_load);
+	}
+
+	/*
+		   .  /proc/<pid>/statm  
+		 ,      descriptor_cache,   
+		     PID    pread. 
+		   mem_loads  0,    false.
+	*/
+	bool get_process_vmemory_load(const int* process_ids, std::size_t process_count, unsigned long long* mem_loads) {
+		if (proc_fd < 0) return false;
+
+		bool ret_value = true;
+		batch_generation++;
+
+		for (std::size_t i = 0; i < process_count; i++) {
+			mem_loads[i] = 0;
+			if (!read_cached_statm(process_ids[i], mem_loads[i])) ret_value = false;
+		}
+
+		/*
+			  ,       
+		*/
+		if (statm_files.size() > process_count) {
+			unrequested_process predicate(batch_generation, descriptors);
+			statm_files.erase_if(predicate);
+		}
+
+		return ret_value;
+	}
+};
+
+}}}}
+#endif
@@ -0,0 +1,573 @@
+#ifndef BOOST_NETWORK_COUNTER_LINUX_HPP
+#define BOOST_NETWORK_COUNTER_LINUX_HPP
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <cstdlib>
+#include <cstring>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <linux/netlink.h>
+#include <linux/sock_diag.h>
+#include <linux/inet_diag.h>
+#include <linux/rtnetlink.h>
+#include <boost/cstdint.hpp>
+#include <boost/array.hpp>
+#include <boost/chrono.hpp>
+#include <boost/container/vector.hpp>
+#include "../open_hash_map.hpp"
+#include "proc_file.hpp"
+#include "socket_index.hpp"
+
+namespace boost { namespace perfomance { namespace detail { namespace linux_ {
+
+/*
+	 TCP    (. include/net/tcp_states.h).  
+	    ,       .
+*/
+enum ETcpState {
+	eTcpEstablished = 1,
+	eTcpSynSent,
+	eTcpSynReceived,
+	eTcpFinWait1,
+	eTcpFinWait2,
+	eTcpTimeWait,
+	eTcpClose,
+	eTcpCloseWait,
+	eTcpLastAck,
+	eTcpListen,
+	eTcpClosing,
+	eTcpNewSynReceived
+};
+
+enum : unsigned long {
+	tcp_state_mask_all = 0xffe,
+	tcp_state_mask_connected = (1ul << eTcpEstablished) | (1ul << eTcpSynSent) | (1ul << eTcpSynReceived) | (1ul << eTcpCloseWait),
+	tcp_state_mask_listen = 1ul << eTcpListen
+};
+
+typedef boost::array<boost::uint32_t, 4> network_address;
+
+/*
+	 struct tcp_info  <linux/tcp.h>   tcpi_bytes_received ( 4.1+).
+	   :    <netinet/tcp.h>, 
+	 Boost.Asio   .
+*/
+typedef struct {
+	boost::uint8_t State;
+	boost::uint8_t CaState;
+	boost::uint8_t Retransmits;
+	boost::uint8_t Probes;
+	boost::uint8_t Backoff;
+	boost::uint8_t Options;
+	boost::uint8_t WindowScale;
+	boost::uint8_t Flags;
+
+	boost::uint32_t Rto;
+	boost::uint32_t Ato;
+	boost::uint32_t SendMss;
+	boost::uint32_t ReceiveMss;
+
+	boost::uint32_t Unacked;
+	boost::uint32_t Sacked;
+	boost::uint32_t Lost;
+	boost::uint32_t Retrans;
+	boost::uint32_t Fackets;
+
+	boost::uint32_t LastDataSent;
+	boost::uint32_t LastAckSent;
+	boost::uint32_t LastDataReceived;
+	boost::uint32_t LastAckReceived;
+
+	boost::uint32_t Pmtu;
+	boost::uint32_t ReceiveSsthresh;
+	boost::uint32_t Rtt;						// 
+	boost::uint32_t RttVariance;
+	boost::uint32_t SendSsthresh;
+	boost::uint32_t SendCwnd;
+	boost::uint32_t AdvertisedMss;
+	boost::uint32_t Reordering;
+
+	boost::uint32_t ReceiveRtt;
+	boost::uint32_t ReceiveSpace;
+
+	boost::uint32_t TotalRetransmits;
+
+	boost::uint64_t PacingRate;
+	boost::uint64_t MaxPacingRate;
+	boost::uint64_t BytesAcked;
+	boost::uint64_t BytesReceived;
+} TcpInfoStruct;
+
+/*
+	 TCP    :   -  ,  -
+	   .         
+	(IPv4     ),     .
+*/
+class tcp_socket_table {
+public:
+	boost::container::vector<unsigned char> Family;			// AF_INET  AF_INET6
+	boost::container::vector<unsigned char> SocketStatus;	// ETcpState
+	boost::container::vector<unsigned short> LocalPort;
+	boost::container::vector<unsigned short> RemotePort;
+	boost::container::vector<network_address> LocalAddress;
+	boost::container::vector<network_address> RemoteAddress;
+	boost::container::vector<unsigned long> Inode;
+	boost::container::vector<unsigned long> Uid;
+	boost::container::vector<unsigned long> ReceiveQueue;
+	boost::container::vector<unsigned long> SendQueue;
+	boost::container::vector<unsigned long> ProcessID;		// 0,    
+	boost::container::vector<unsigned long> ProcessNameId;	//     netword_counter
+	boost::container::vector<unsigned long long> InBandwidthBytes;	//      
+	boost::container::vector<unsigned long long> OutBandwidthBytes;
+	boost::container::vector<unsigned long> RttMicroseconds;
+	boost::container::vector<unsigned long> Retransmits;			//      
+
+	std::size_t size() const {
+		return Inode.size();
+	}
+
+	void clear() {
+		Family.clear();
+		SocketStatus.clear();
+		LocalPort.clear();
+		RemotePort.clear();
+		LocalAddress.clear();
+		RemoteAddress.clear();
+		Inode.clear();
+		Uid.clear();
+		ReceiveQueue.clear();
+		SendQueue.clear();
+		ProcessID.clear();
+		ProcessNameId.clear();
+		InBandwidthBytes.clear();
+		OutBandwidthBytes.clear();
+		RttMicroseconds.clear();
+		Retransmits.clear();
+	}
+
+	void reserve(std::size_t capacity) {
+		Family.reserve(capacity);
+		SocketStatus.reserve(capacity);
+		LocalPort.reserve(capacity);
+		RemotePort.reserve(capacity);
+		LocalAddress.reserve(capacity);
+		RemoteAddress.reserve(capacity);
+		Inode.reserve(capacity);
+		Uid.reserve(capacity);
+		ReceiveQueue.reserve(capacity);
+		SendQueue.reserve(capacity);
+		ProcessID.reserve(capacity);
+		ProcessNameId.reserve(capacity);
+		InBandwidthBytes.reserve(capacity);
+		OutBandwidthBytes.reserve(capacity);
+		RttMicroseconds.reserve(capacity);
+		Retransmits.reserve(capacity);
+	}
+
+	/*
+		    , buffer   INET6_ADDRSTRLEN 
+	*/
+	bool format_address(std::size_t index, bool remote, char* buffer, std::size_t buffer_size) const {
+		const network_address& address = remote ? RemoteAddress[index] : LocalAddress[index];
+		return ::inet_ntop(Family[index], address.data(), buffer, (socklen_t)buffer_size) != NULL;
+	}
+};
+
+/*
+	  .      Windows ,
+	     get_global_network_info.
+*/
+typedef struct {
+	unsigned long CountOfUDPListeners;		//  UDP  (IPv4  IPv6)
+	unsigned long CountOfTCPErrors;
+	unsigned long CountOfTCPConnections;
+	unsigned long MaxCountOfTCPConnections;	// ~0,   
+	double RetransmitsPerSecond;
+	double ResetsPerSecond;
+	double ListenOverflowsPerSecond;
+	double UdpReceiveBufferErrorsPerSecond;
+	double ActiveOpensPerSecond;
+	double PassiveOpensPerSecond;
+} NetworkGlobalStatus;
+
+class netword_counter {
+private:
+	enum ENetworkCounter {
+		eRetransSegs,
+		eOutRsts,
+		eListenOverflows,
+		eRcvbufErrors,
+		eActiveOpens,
+		ePassiveOpens,
+		eNetworkCounterCount
+	};
+
+	typedef struct {
+		nlmsghdr Header;
+		inet_diag_req_v2 Request;
+	} InetDiagRequestStruct;
+
+	/*
+		     .  - cookie , 
+		  ,         
+		 .
+	*/
+	typedef struct {
+		unsigned long long BytesReceived;
+		unsigned long long BytesAcked;
+		boost::uint64_t Timestamp;
+		unsigned long Generation;
+	} FlowCountersStruct;
+
+	int netlink_fd;
+	boost::uint32_t sequence;
+	socket_process_index process_index;
+
+	open_hash_map<FlowCountersStruct> flows;
+	unsigned long dump_generation;
+	boost::uint64_t dump_timestamp;
+	std::size_t seen_flows;
+
+	proc_file snmp_file;
+	proc_file netstat_file;
+	proc_file sockstat_file;
+	proc_file sockstat6_file;
+	unsigned long long prev_counters[eNetworkCounterCount];
+	boost::uint64_t prev_counters_timestamp;
+
+	/*
+		    . 64       ,
+		     recv.
+	*/
+	boost::container::vector<char> receive_buffer;
+
+	netword_counter(const netword_counter&);
+	netword_counter& operator=(const netword_counter&);
+
+	struct stale_flow {
+		unsigned long current_generation;
+
+		explicit stale_flow(unsigned long generation) : current_generation(generation) {}
+
+		bool operator()(boost::uint64_t, const FlowCountersStruct& flow) {
+			return flow.Generation != current_generation;
+		}
+	};
+
+	static boost::uint64_t steady_nanoseconds() {
+		return (boost::uint64_t)boost::chrono::duration_cast<boost::chrono::nanoseconds>(
+			boost::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	/*
+		 /proc/net/snmp  /proc/net/netstat   :  
+		  ,        . names -  
+		,    values    .
+	*/
+	static bool parse_snmp_section(const proc_file& file, const char* section, std::size_t section_size,
+		const char* const* names, std::size_t names_count, long long* values) {
+		text_scanner header(file);
+		if (!header.find_line(section, section_size)) return false;
+
+		text_scanner data(header);
+		data.next_line();
+		if (!data.skip_prefix(section, section_size)) return false;
+
+		std::size_t found_count = 0;
+		while (!header.at_line_end() && found_count < names_count) {
+			header.skip_spaces();
+			if (header.at_line_end()) break;
+
+			const char* name = header.cur;
+			header.skip_token();
+			std::size_t name_size = (std::size_t)(header.cur - name);
+
+			long long value = 0;
+			if (!data.parse(value)) return false;
+
+			for (std::size_t i = 0; i < names_count; i++) {
+				if (std::strlen(names[i]) == name_size && !std::memcmp(names[i], name, name_size)) {
+					values[i] = value;
+					found_count++;
+				}
+			}
+		}
+
+		return found_count == names_count;
+	}
+
+	static bool parse_sockstat_inuse(const proc_file& file, const char* section, std::size_t section_size, unsigned long long& value) {
+		text_scanner scanner(file);
+		return scanner.find_line(section, section_size) && scanner.skip_prefix(" inuse", 6) && scanner.parse(value);
+	}
+
+	static double calculate_counter_rate(unsigned long long current, unsigned long long previous, boost::uint64_t elapsed) {
+		if (current <= previous || !elapsed) return 0.0;
+		return (double)(current - previous) * 1e9 / (double)elapsed;
+	}
+
+	static unsigned long long calculate_rate(unsigned long long current, unsigned long long previous, boost::uint64_t elapsed) {
+		if (current <= previous || !elapsed) return 0;
+		return (unsigned long long)((double)(current - previous) * 1e9 / (double)elapsed);
+	}
+
+	bool send_dump_request(unsigned char family, unsigned long state_mask) {
+		InetDiagRequestStruct request;
+		std::memset(&request, 0, sizeof(request));
+
+		request.Header.nlmsg_len = sizeof(request);
+		request.Header.nlmsg_type = SOCK_DIAG_BY_FAMILY;
+		request.Header.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+		request.Header.nlmsg_seq = ++sequence;
+		request.Request.sdiag_family = family;
+		request.Request.sdiag_protocol = IPPROTO_TCP;
+		request.Request.idiag_states = (boost::uint32_t)state_mask;
+		request.Request.idiag_ext = 1 << (INET_DIAG_INFO - 1);
+
+		sockaddr_nl address;
+		std::memset(&address, 0, sizeof(address));
+		address.nl_family = AF_NETLINK;
+
+		for (;;) {
+			ssize_t ret_value = ::sendto(netlink_fd, &request, sizeof(request), 0, (const sockaddr*)&address, sizeof(address));
+			if (ret_value == (ssize_t)sizeof(request)) return true;
+			if (ret_value < 0 && errno == EINTR) continue;
+			return false;
+		}
+	}
+
+	/*
+		    tcp_info (BytesReceived, BytesAcked) 
+		 ,      
+	*/
+	void append_flow_statistics(tcp_socket_table& table, const inet_diag_msg* message, const TcpInfoStruct* info) {
+		unsigned long long in_rate = 0;
+		unsigned long long out_rate = 0;
+		unsigned long rtt = 0;
+		unsigned long retransmits = 0;
+
+		boost::uint64_t cookie = ((boost::uint64_t)message->id.idiag_cookie[1] << 32) | message->id.idiag_cookie[0];
+
+		if (info && cookie != ((boost::uint64_t)INET_DIAG_NOCOOKIE << 32 | INET_DIAG_NOCOOKIE)) {
+			bool inserted = false;
+			FlowCountersStruct& flow = flows.insert(cookie, inserted);
+
+			if (!inserted && flow.Timestamp < dump_timestamp) {
+				boost::uint64_t elapsed = dump_timestamp - flow.Timestamp;
+				in_rate = calculate_rate(info->BytesReceived, flow.BytesReceived, elapsed);
+				out_rate = calculate_rate(info->BytesAcked, flow.BytesAcked, elapsed);
+			}
+
+			flow.BytesReceived = info->BytesReceived;
+			flow.BytesAcked = info->BytesAcked;
+			flow.Timestamp = dump_timestamp;
+			flow.Generation = dump_generation;
+			seen_flows++;
+
+			rtt = info->Rtt;
+			retransmits = info->TotalRetransmits;
+		}
+
+		table.InBandwidthBytes.push_back(in_rate);
+		table.OutBandwidthBytes.push_back(out_rate);
+		table.RttMicroseconds.push_back(rtt);
+		table.Retransmits.push_back(retransmits);
+	}
+
+	void append_socket(tcp_socket_table& table, const nlmsghdr* header) {
+		const inet_diag_msg* message = (const inet_diag_msg*)NLMSG_DATA(header);
+		network_address local_address;
+		network_address remote_address;
+
+		std::memcpy(local_address.data(), message->id.idiag_src, sizeof(local_address));
+		std::memcpy(remote_address.data(), message->id.idiag_dst, sizeof(remote_address));
+
+		table.Family.push_back(message->idiag_family);
+		table.SocketStatus.push_back(message->idiag_state);
+		table.LocalPort.push_back(ntohs(message->id.idiag_sport));
+		table.RemotePort.push_back(ntohs(message->id.idiag_dport));
+		table.LocalAddress.push_back(local_address);
+		table.RemoteAddress.push_back(remote_address);
+		table.Inode.push_back(message->idiag_inode);
+		table.Uid.push_back(message->idiag_uid);
+		table.ReceiveQueue.push_back(message->idiag_rqueue);
+		table.SendQueue.push_back(message->idiag_wqueue);
+		table.ProcessID.push_back(0);
+		table.ProcessNameId.push_back(0);
+
+		/*
+			    tcp_info,    
+		*/
+		TcpInfoStruct info;
+		bool has_info = false;
+		int attributes_size = (int)(header->nlmsg_len - NLMSG_LENGTH(sizeof(inet_diag_msg)));
+		const rtattr* attribute = (const rtattr*)(message + 1);
+
+		for (; RTA_OK(attribute, attributes_size); attribute = RTA_NEXT(attribute, attributes_size)) {
+			if (attribute->rta_type != INET_DIAG_INFO) continue;
+
+			std::size_t info_size = RTA_PAYLOAD(attribute);
+			std::memset(&info, 0, sizeof(info));
+			std::memcpy(&info, RTA_DATA(attribute), info_size < sizeof(info) ? info_size : sizeof(info));
+			has_info = true;
+		}
+
+		append_flow_statistics(table, message, has_info ? &info : NULL);
+	}
+
+	/*
+		    NLMSG_DONE,   inet_diag_msg  
+	*/
+	bool receive_dump(tcp_socket_table& table) {
+		for (;;) {
+			ssize_t read_size = ::recv(netlink_fd, &receive_buffer[0], receive_buffer.size(), 0);
+			if (read_size < 0) {
+				if (errno == EINTR) continue;
+				return false;
+			}
+
+			const nlmsghdr* header = (const nlmsghdr*)&receive_buffer[0];
+			int remaining = (int)read_size;
+
+			for (; NLMSG_OK(header, remaining); header = NLMSG_NEXT(header, remaining)) {
+				if (header->nlmsg_seq != sequence) continue;
+				if (header->nlmsg_type == NLMSG_DONE) return true;
+				if (header->nlmsg_type == NLMSG_ERROR) return false;
+				if (header->nlmsg_len < NLMSG_LENGTH(sizeof(inet_diag_msg))) continue;
+
+				append_socket(table, header);
+			}
+		}
+	}
+
+public:
+	netword_counter() : netlink_fd(-1), sequence(0), flows(4096), dump_generation(0), dump_timestamp(0), seen_flows(0), prev_counters_timestamp(0) {
+		netlink_fd = ::socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_SOCK_DIAG);
+		receive_buffer.resize(65536);
+		std::memset(prev_counters, 0, sizeof(prev_counters));
+
+		snmp_file.open("/proc/net/snmp");
+		netstat_file.open("/proc/net/netstat", 8192);
+		sockstat_file.open("/proc/net/sockstat", 1024);
+		sockstat6_file.open("/proc/net/sockstat6", 1024);
+	}
+
+	~netword_counter() {
+		if (netlink_fd >= 0) ::close(netlink_fd);
+	}
+
+	/*
+		   TCP  (IPv4  IPv6),   
+		 state_mask (   ETcpState).    .
+		     ,  
+		    .
+	*/
+	bool get_tcp_table(tcp_socket_table& table, unsigned long state_mask = tcp_state_mask_all) {
+		if (netlink_fd < 0) return false;
+		table.clear();
+
+		dump_generation++;
+		dump_timestamp = steady_nanoseconds();
+		seen_flows = 0;
+
+		if (!send_dump_request(AF_INET, state_mask) || !receive_dump(table)) return false;
+		if (!send_dump_request(AF_INET6, state_mask) || !receive_dump(table)) return false;
+
+		/*
+			   ,     
+		*/
+		if ((flows.size() - seen_flows) * 4 > flows.size()) {
+			stale_flow predicate(dump_generation);
+			flows.erase_if(predicate);
+		}
+
+		return true;
+	}
+
+	/*
+		  TCP  UDP  /proc/net/snmp  /proc/net/netstat ( , 
+		 nstat).       pread.
+		      .
+	*/
+	bool get_global_network_info(NetworkGlobalStatus& global_status) {
+		static const char* const tcp_names[] = { "RetransSegs", "OutRsts", "ActiveOpens", "PassiveOpens", "CurrEstab", "InErrs", "MaxConn" };
+		static const char* const udp_names[] = { "RcvbufErrors" };
+		static const char* const tcp_ext_names[] = { "ListenOverflows" };
+
+		long long tcp_values[7] = {};
+		long long udp_values[1] = {};
+		long long tcp_ext_values[1] = {};
+		unsigned long long udp_sockets = 0;
+		unsigned long long udp6_sockets = 0;
+
+		if (!snmp_file.read() || !netstat_file.read()) return false;
+		boost::uint64_t timestamp = steady_nanoseconds();
+
+		if (!parse_snmp_section(snmp_file, "Tcp:", 4, tcp_names, 7, tcp_values)) return false;
+		if (!parse_snmp_section(snmp_file, "Udp:", 4, udp_names, 1, udp_values)) return false;
+		if (!parse_snmp_section(netstat_file, "TcpExt:", 7, tcp_ext_names, 1, tcp_ext_values)) return false;
+
+		if (sockstat_file.read_head()) parse_sockstat_inuse(sockstat_file, "UDP:", 4, udp_sockets);
+		if (sockstat6_file.read_head()) parse_sockstat_inuse(sockstat6_file, "UDP6:", 5, udp6_sockets);
+
+		unsigned long long counters[eNetworkCounterCount];
+		counters[eRetransSegs] = (unsigned long long)tcp_values[0];
+		counters[eOutRsts] = (unsigned long long)tcp_values[1];
+		counters[eActiveOpens] = (unsigned long long)tcp_values[2];
+		counters[ePassiveOpens] = (unsigned long long)tcp_values[3];
+		counters[eRcvbufErrors] = (unsigned long long)udp_values[0];
+		counters[eListenOverflows] = (unsigned long long)tcp_ext_values[0];
+
+		boost::uint64_t elapsed = prev_counters_timestamp ? timestamp - prev_counters_timestamp : 0;
+
+		global_status.CountOfUDPListeners = (unsigned long)(udp_sockets + udp6_sockets);
+		global_status.CountOfTCPErrors = (unsigned long)tcp_values[5];
+		global_status.CountOfTCPConnections = (unsigned long)tcp_values[4];
+		global_status.MaxCountOfTCPConnections = tcp_values[6] < 0 ? ~0ul : (unsigned long)tcp_values[6];
+		global_status.RetransmitsPerSecond = calculate_counter_rate(counters[eRetransSegs], prev_counters[eRetransSegs], elapsed);
+		global_status.ResetsPerSecond = calculate_counter_rate(counters[eOutRsts], prev_counters[eOutRsts], elapsed);
+		global_status.ListenOverflowsPerSecond = calculate_counter_rate(counters[eListenOverflows], prev_counters[eListenOverflows], elapsed);
+		global_status.UdpReceiveBufferErrorsPerSecond = calculate_counter_rate(counters[eRcvbufErrors], prev_counters[eRcvbufErrors], elapsed);
+		global_status.ActiveOpensPerSecond = calculate_counter_rate(counters[eActiveOpens], prev_counters[eActiveOpens], elapsed);
+		global_status.PassiveOpensPerSecond = calculate_counter_rate(counters[ePassiveOpens], prev_counters[ePassiveOpens], elapsed);
+
+		std::memcpy(prev_counters, counters, sizeof(prev_counters));
+		prev_counters_timestamp = timestamp;
+		return true;
+	}
+
+	/*
+		  ProcessID  ProcessNameId.  inode -> PID 
+		,         
+		   .
+	*/
+	bool resolve_processes(tcp_socket_table& table) {
+		if (!process_index.refresh()) return false;
+
+		for (std::size_t i = 0; i < table.size(); i++) {
+			if (!process_index.find(table.Inode[i], table.ProcessID[i], table.ProcessNameId[i])) {
+				table.ProcessID[i] = 0;
+				table.ProcessNameId[i] = 0;
+			}
+		}
+
+		return true;
+	}
+
+	/*
+		      ProcessNameId,   
+		 resolve_processes
+	*/
+	const char* get_process_name(unsigned long name_id) const {
+		return process_index.get_process_name(name_id);
+	}
+};
+
+}}}}
+#endif
@@ -0,0 +1,131 @@
+#ifndef BOOST_PROC_DIRECTORY_LINUX_HPP
+#define BOOST_PROC_DIRECTORY_LINUX_HPP
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <cstdlib>
+#include <cstring>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <boost/cstdint.hpp>
+#include <boost/container/vector.hpp>
+
+namespace boost { namespace perfomance { namespace detail { namespace linux_ {
+
+/*
+	    getdents64   .   
+	readdir    DIR   ,       
+	     .
+*/
+class proc_directory {
+private:
+	typedef struct {
+		boost::uint64_t Inode;
+		boost::int64_t Offset;
+		unsigned short RecordLength;
+		unsigned char Type;
+		char Name[1];
+	} DirectoryEntryStruct;
+
+	int fd;
+	std::size_t data_size;
+	std::size_t position;
+	boost::container::vector<char> buffer;
+
+	proc_directory(const proc_directory&);
+	proc_directory& operator=(const proc_directory&);
+
+	bool fill() {
+		for (;;) {
+			long ret_value = ::syscall(SYS_getdents64, fd, &buffer[0], buffer.size());
+			if (ret_value >= 0) {
+				data_size = (std::size_t)ret_value;
+				position = 0;
+				return data_size != 0;
+			}
+
+			if (errno != EINTR) return false;
+		}
+	}
+
+public:
+	explicit proc_directory(std::size_t buffer_size = 32768) : fd(-1), data_size(0), position(0) {
+		buffer.resize(buffer_size);
+	}
+
+	~proc_directory() {
+		close();
+	}
+
+	bool open(const char* path, int dir_fd = AT_FDCWD) {
+		close();
+		fd = ::openat(dir_fd, path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+		return fd >= 0;
+	}
+
+	void close() {
+		if (fd >= 0) ::close(fd);
+		fd = -1;
+		data_size = 0;
+		position = 0;
+	}
+
+	bool is_open() const {
+		return fd >= 0;
+	}
+
+	int native_handle() const {
+		return fd;
+	}
+
+	/*
+		    .  /proc    
+		   .
+	*/
+	bool rewind() {
+		data_size = 0;
+		position = 0;
+		return ::lseek(fd, 0, SEEK_SET) == 0;
+	}
+
+	/*
+		  , "."  ".." . NULL   
+		  .
+	*/
+	const char* next(unsigned char* type = NULL) {
+		for (;;) {
+			if (position >= data_size && !fill()) return NULL;
+
+			const DirectoryEntryStruct* entry = (const DirectoryEntryStruct*)&buffer[position];
+			position += entry->RecordLength;
+
+			const char* name = entry->Name;
+			if (name[0] == '.' && (!name[1] || (name[1] == '.' && !name[2]))) continue;
+
+			if (type) *type = entry->Type;
+			return name;
+		}
+	}
+
+	/*
+		      (PID,  ,  CPU)
+	*/
+	static bool parse_number(const char* name, unsigned long& value) {
+		if (*name < '0' || *name > '9') return false;
+
+		value = 0;
+		for (; *name; name++) {
+			if (*name < '0' || *name > '9') return false;
+			value = value * 10 + (unsigned long)(*name - '0');
+		}
+
+		return true;
+	}
+};
+
+}}}}
+#endif
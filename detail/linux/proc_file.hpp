@@ -0,0 +1,258 @@
+#ifndef BOOST_PROC_FILE_LINUX_HPP
+#define BOOST_PROC_FILE_LINUX_HPP
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <cstdlib>
+#include <cstring>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <boost/cstdint.hpp>
+#include <boost/container/vector.hpp>
+#include <boost/move/utility_core.hpp>
+
+/*
+	   linux_,   linux,     gnu++ 
+	  linux,        .
+*/
+namespace boost { namespace perfomance { namespace detail { namespace linux_ {
+
+/*
+	  /proc  /sys,        pread
+	   .    ,      ,
+	       .
+*/
+class proc_file {
+private:
+	int fd;
+	std::size_t data_size;
+	boost::container::vector<char> buffer;
+
+	proc_file(const proc_file&);
+	proc_file& operator=(const proc_file&);
+
+	bool pread_at(std::size_t offset, std::size_t& read_size) {
+		for (;;) {
+			ssize_t ret_value = ::pread(fd, &buffer[offset], buffer.size() - offset, (off_t)offset);
+			if (ret_value >= 0) {
+				read_size = (std::size_t)ret_value;
+				return true;
+			}
+
+			if (errno != EINTR) return false;
+		}
+	}
+
+public:
+	proc_file() : fd(-1), data_size(0) {}
+
+	explicit proc_file(const char* path, std::size_t initial_size = 4096, int dir_fd = AT_FDCWD) : fd(-1), data_size(0) {
+		open(path, initial_size, dir_fd);
+	}
+
+	proc_file(proc_file&& other) : fd(other.fd), data_size(other.data_size), buffer(boost::move(other.buffer)) {
+		other.fd = -1;
+		other.data_size = 0;
+	}
+
+	proc_file& operator=(proc_file&& other) {
+		if (this != &other) {
+			close();
+			fd = other.fd;
+			data_size = other.data_size;
+			buffer = boost::move(other.buffer);
+			other.fd = -1;
+			other.data_size = 0;
+		}
+
+		return *this;
+	}
+
+	~proc_file() {
+		close();
+	}
+
+	bool open(const char* path, std::size_t initial_size = 4096, int dir_fd = AT_FDCWD) {
+		close();
+		fd = ::openat(dir_fd, path, O_RDONLY | O_CLOEXEC);
+		if (fd < 0) return false;
+
+		if (buffer.size() < initial_size) buffer.resize(initial_size);
+		return true;
+	}
+
+	void close() {
+		if (fd >= 0) ::close(fd);
+		fd = -1;
+		data_size = 0;
+	}
+
+	bool is_open() const {
+		return fd >= 0;
+	}
+
+	int native_handle() const {
+		return fd;
+	}
+
+	/*
+		    . ,    , 
+		        .
+	*/
+	void grow() {
+		buffer.resize(buffer.size() * 2);
+	}
+
+	/*
+		    .  seq_file     , 
+		  ,   ,      (
+		 cpu  /proc/stat),    .
+	*/
+	bool read_head() {
+		if (fd < 0) return false;
+		return pread_at(0, data_size);
+	}
+
+	/*
+		  .     ,      .
+	*/
+	bool read() {
+		if (fd < 0) return false;
+		data_size = 0;
+
+		for (;;) {
+			if (data_size == buffer.size()) grow();
+
+			std::size_t read_size = 0;
+			if (!pread_at(data_size, read_size)) return false;
+			if (read_size == 0) return true;
+			data_size += read_size;
+		}
+	}
+
+	bool is_full() const {
+		return data_size == buffer.size();
+	}
+
+	const char* begin() const {
+		return buffer.data();
+	}
+
+	const char* end() const {
+		return buffer.data() + data_size;
+	}
+
+	std::size_t size() const {
+		return data_size;
+	}
+};
+
+/*
+	    .      [cur, end)
+	      .
+*/
+struct text_scanner {
+	const char* cur;
+	const char* end;
+
+	text_scanner(const char* begin_ptr, const char* end_ptr) : cur(begin_ptr), end(end_ptr) {}
+	explicit text_scanner(const proc_file& file) : cur(file.begin()), end(file.end()) {}
+
+	bool eof() const {
+		return cur >= end;
+	}
+
+	bool at_line_end() const {
+		return cur >= end || *cur == '\n';
+	}
+
+	void skip_spaces() {
+		while (cur < end && (*cur == ' ' || *cur == '\t')) cur++;
+	}
+
+	void skip_token() {
+		skip_spaces();
+		while (cur < end && *cur != ' ' && *cur != '\t' && *cur != '\n') cur++;
+	}
+
+	/*
+		       
+	*/
+	void next_line() {
+		const char* line_end = (const char*)std::memchr(cur, '\n', (std::size_t)(end - cur));
+		cur = line_end ? line_end + 1 : end;
+	}
+
+	bool starts_with(const char* prefix, std::size_t prefix_size) const {
+		return (std::size_t)(end - cur) >= prefix_size && !std::memcmp(cur, prefix, prefix_size);
+	}
+
+	bool skip_prefix(const char* prefix, std::size_t prefix_size) {
+		if (!starts_with(prefix, prefix_size)) return false;
+		cur += prefix_size;
+		return true;
+	}
+
+	/*
+		  ,    ,      
+	*/
+	bool find_line(const char* prefix, std::size_t prefix_size) {
+		while (cur < end) {
+			if (skip_prefix(prefix, prefix_size)) return true;
+			next_line();
+		}
+
+		return false;
+	}
+
+	bool parse(unsigned long long& value) {
+		skip_spaces();
+		if (cur >= end || (unsigned)(*cur - '0') > 9) return false;
+
+		unsigned long long ret_value = 0;
+		while (cur < end && (unsigned)(*cur - '0') <= 9) {
+			ret_value = ret_value * 10 + (unsigned)(*cur - '0');
+			cur++;
+		}
+
+		value = ret_value;
+		return true;
+	}
+
+	bool parse(long long& value) {
+		skip_spaces();
+		bool negative = cur < end && *cur == '-';
+		if (negative) cur++;
+
+		unsigned long long abs_value = 0;
+		if (!parse(abs_value)) return false;
+
+		value = negative ? -(long long)abs_value : (long long)abs_value;
+		return true;
+	}
+
+	/*
+		   ,    PSI ("avg10=1.25")
+	*/
+	bool parse(double& value) {
+		unsigned long long integer_part = 0;
+		if (!parse(integer_part)) return false;
+
+		double ret_value = (double)integer_part;
+		if (cur < end && *cur == '.') {
+			double scale = 0.1;
+			for (cur++; cur < end && (unsigned)(*cur - '0') <= 9; cur++, scale *= 0.1) {
+				ret_value += (*cur - '0') * scale;
+			}
+		}
+
+		value = ret_value;
+		return true;
+	}
+};
+
+}}}}
+#endif
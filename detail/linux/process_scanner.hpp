@@ -0,0 +1,339 @@
+#ifndef BOOST_PROCESS_SCANNER_LINUX_HPP
+#define BOOST_PROCESS_SCANNER_LINUX_HPP
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <algorithm>
+#include <dirent.h>
+#include <time.h>
+#include <unistd.h>
+#include <boost/cstdint.hpp>
+#include <boost/container/vector.hpp>
+#include "../open_hash_map.hpp"
+#include "../string_table.hpp"
+#include "descriptor_cache.hpp"
+#include "proc_directory.hpp"
+#include "proc_file.hpp"
+
+namespace boost { namespace perfomance { namespace detail { namespace linux_ {
+
+enum EProcessRanking {
+	eRankCpuLoad = 0,		//      
+	eRankResident,			//   
+	eRankResidentGrowth		//       
+};
+
+typedef struct {
+	unsigned long ProcessID;
+	unsigned long ParentProcessID;
+	unsigned long NameId;				//    get_process_name
+	unsigned long ThreadCount;
+	float CpuLoad;						//       ( 1  ), 0   
+	unsigned long long CpuTime;			// user + system   , 
+	unsigned long long ResidentBytes;
+	long long ResidentDelta;			//      
+} ProcessUsageStruct;
+
+/*
+	        . /proc 
+	 getdents64   ,      
+	/proc/<pid>/stat,      ,  RSS,  .
+
+	      -  PID:  stat
+	  (  -  pread),     
+	 .  PID     .
+	      .
+
+	    (nth_element)     N
+	,    .
+*/
+class process_scanner {
+private:
+	typedef struct {
+		int Fd;
+		unsigned long Generation;
+		unsigned long NameId;
+		unsigned long long StartTime;
+		unsigned long long CpuTicks;
+		unsigned long long ResidentPages;
+	} ProcessStateStruct;
+
+	typedef struct {
+		unsigned long ParentProcessID;
+		unsigned long ThreadCount;
+		unsigned long long CpuTicks;
+		unsigned long long StartTime;
+		unsigned long long ResidentPages;
+		const char* Name;
+		std::size_t NameSize;
+	} StatFieldsStruct;
+
+	int proc_fd;
+	proc_directory process_directory;
+	descriptor_cache descriptors;
+	open_hash_map<ProcessStateStruct> processes;
+	string_table process_names;
+	boost::container::vector<ProcessUsageStruct> usage;
+
+	unsigned long generation;
+	boost::uint64_t timestamp;
+	unsigned long long page_size;
+	double nanoseconds_per_tick;
+	char stat_buffer[1024];
+
+	process_scanner(const process_scanner&);
+	process_scanner& operator=(const process_scanner&);
+
+	struct dead_process {
+		unsigned long current_generation;
+		descriptor_cache& descriptors;
+
+		dead_process(unsigned long generation_value, descriptor_cache& cache) : current_generation(generation_value), descriptors(cache) {}
+
+		bool operator()(boost::uint64_t, ProcessStateStruct& process) {
+			if (process.Generation == current_generation) return false;
+			descriptors.release(process.Fd);
+			return true;
+		}
+	};
+
+	struct close_process {
+		descriptor_cache& descriptors;
+
+		explicit close_process(descriptor_cache& cache) : descriptors(cache) {}
+
+		void operator()(boost::uint64_t, ProcessStateStruct& process) {
+			descriptors.release(process.Fd);
+		}
+	};
+
+	struct cpu_load_greater {
+		bool operator()(const ProcessUsageStruct& left, const ProcessUsageStruct& right) const {
+			return left.CpuLoad > right.CpuLoad || (left.CpuLoad == right.CpuLoad && left.CpuTime > right.CpuTime);
+		}
+	};
+
+	struct resident_greater {
+		bool operator()(const ProcessUsageStruct& left, const ProcessUsageStruct& right) const {
+			return left.ResidentBytes > right.ResidentBytes;
+		}
+	};
+
+	struct resident_growth_greater {
+		bool operator()(const ProcessUsageStruct& left, const ProcessUsageStruct& right) const {
+			return left.ResidentDelta > right.ResidentDelta;
+		}
+	};
+
+	static boost::uint64_t steady_nanoseconds() {
+		timespec now;
+		::clock_gettime(CLOCK_MONOTONIC, &now);
+		return (boost::uint64_t)now.tv_sec * 1000000000ull + (boost::uint64_t)now.tv_nsec;
+	}
+
+	/*
+		      ,    
+		  .    state (3), ppid (4), ... utime (14),
+		stime (15), ... num_threads (20), itrealvalue (21), starttime (22), vsize (23), rss (24).
+	*/
+	static bool parse_stat(const char* data, std::size_t size, StatFieldsStruct& fields) {
+		const char* name_begin = (const char*)std::memchr(data, '(', size);
+		const char* name_end = (const char*)::memrchr(data, ')', size);
+		if (!name_begin || !name_end || name_end < name_begin) return false;
+
+		fields.Name = name_begin + 1;
+		fields.NameSize = (std::size_t)(name_end - name_begin - 1);
+
+		text_scanner scanner(name_end + 1, data + size);
+		unsigned long long parent = 0;
+		unsigned long long user_time = 0;
+		unsigned long long system_time = 0;
+		unsigned long long thread_count = 0;
+
+		scanner.skip_token();
+		if (!scanner.parse(parent)) return false;
+		for (int i = 5; i <= 13; i++) scanner.skip_token();
+		if (!scanner.parse(user_time) || !scanner.parse(system_time)) return false;
+		for (int i = 16; i <= 19; i++) scanner.skip_token();
+		if (!scanner.parse(thread_count)) return false;
+		scanner.skip_token();
+		if (!scanner.parse(fields.StartTime)) return false;
+		scanner.skip_token();
+		if (!scanner.parse(fields.ResidentPages)) return false;
+
+		fields.ParentProcessID = (unsigned long)parent;
+		fields.ThreadCount = (unsigned long)thread_count;
+		fields.CpuTicks = user_time + system_time;
+		return true;
+	}
+
+	bool read_stat(unsigned long pid, ProcessStateStruct& process, StatFieldsStruct& fields) {
+		ssize_t read_size = descriptors.read(process.Fd, stat_buffer, sizeof(stat_buffer));
+		if (read_size < 0) {
+			char path[32];
+			std::snprintf(path, sizeof(path), "%lu/stat", pid);
+			read_size = descriptors.open_read(proc_fd, path, process.Fd, stat_buffer, sizeof(stat_buffer));
+		}
+
+		return read_size > 0 && parse_stat(stat_buffer, (std::size_t)read_size, fields);
+	}
+
+	void refresh_process(unsigned long pid, double ticks_to_load) {
+		bool inserted = false;
+		ProcessStateStruct& process = processes.insert(pid, inserted);
+		process.Generation = generation;
+		if (inserted) process.Fd = -1;
+
+		StatFieldsStruct fields;
+		if (!read_stat(pid, process, fields)) return;
+
+		/*
+			     PID   :   
+		*/
+		bool is_new = inserted || process.StartTime != fields.StartTime;
+		if (is_new) {
+			process.StartTime = fields.StartTime;
+			process.CpuTicks = fields.CpuTicks;
+			process.ResidentPages = fields.ResidentPages;
+		}
+
+		/*
+			 exec   PID   ,   ,  
+			   
+		*/
+		const char* current_name = process_names.get(process.NameId);
+		if (is_new || std::strlen(current_name) != fields.NameSize || std::memcmp(current_name, fields.Name, fields.NameSize)) {
+			process.NameId = process_names.intern(fields.Name, fields.NameSize);
+		}
+
+		ProcessUsageStruct row;
+		row.ProcessID = pid;
+		row.ParentProcessID = fields.ParentProcessID;
+		row.NameId = process.NameId;
+		row.ThreadCount = fields.ThreadCount;
+		row.CpuLoad = (float)((double)(fields.CpuTicks - process.CpuTicks) * ticks_to_load);
+		row.CpuTime = (unsigned long long)((double)fields.CpuTicks * nanoseconds_per_tick);
+		row.ResidentBytes = fields.ResidentPages * page_size;
+		row.ResidentDelta = ((long long)fields.ResidentPages - (long long)process.ResidentPages) * (long long)page_size;
+		usage.push_back(row);
+
+		process.CpuTicks = fields.CpuTicks;
+		process.ResidentPages = fields.ResidentPages;
+	}
+
+	template <class Compare>
+	void select_top(std::size_t count, boost::container::vector<ProcessUsageStruct>& top, Compare compare) {
+		if (count < usage.size()) std::nth_element(usage.begin(), usage.begin() + count, usage.end(), compare);
+
+		top.assign(usage.begin(), usage.begin() + count);
+		std::sort(top.begin(), top.end(), compare);
+	}
+
+public:
+	/*
+		expected_processes -   ,    
+		    .    
+		  ,        (
+		RLIMIT_NOFILE   , descriptor_budget),      
+		      .
+	*/
+	explicit process_scanner(std::size_t expected_processes = 1024)
+		: proc_fd(-1), processes(expected_processes), generation(0), timestamp(0) {
+		long system_page_size = ::sysconf(_SC_PAGESIZE);
+		long ticks_per_second = ::sysconf(_SC_CLK_TCK);
+		page_size = system_page_size > 0 ? (unsigned long long)system_page_size : 4096;
+		nanoseconds_per_tick = 1e9 / (ticks_per_second > 0 ? (double)ticks_per_second : 100.0);
+
+		usage.reserve(expected_processes);
+		if (process_directory.open("/proc")) proc_fd = process_directory.native_handle();
+	}
+
+	~process_scanner() {
+		close_process functor(descriptors);
+		processes.for_each(functor);
+	}
+
+	/*
+		 /proc    .   
+		  ,      .
+	*/
+	bool refresh() {
+		if (proc_fd < 0 || !process_directory.rewind()) return false;
+
+		boost::uint64_t now = steady_nanoseconds();
+		double ticks_to_load = timestamp && now > timestamp ? nanoseconds_per_tick / (double)(now - timestamp) : 0.0;
+
+		generation++;
+		timestamp = now;
+		usage.clear();
+
+		std::size_t listed_count = 0;
+		const char* name = NULL;
+		unsigned char type = 0;
+
+		while ((name = process_directory.next(&type)) != NULL) {
+			unsigned long pid = 0;
+			if ((type != DT_DIR && type != DT_UNKNOWN) || !proc_directory::parse_number(name, pid)) continue;
+
+			refresh_process(pid, ticks_to_load);
+			listed_count++;
+		}
+
+		if (listed_count != processes.size()) {
+			dead_process predicate(generation, descriptors);
+			processes.erase_if(predicate);
+		}
+
+		return true;
+	}
+
+	/*
+		       /proc.  
+		 get_top.
+	*/
+	const boost::container::vector<ProcessUsageStruct>& get_processes() const {
+		return usage;
+	}
+
+	std::size_t get_process_count() const {
+		return usage.size();
+	}
+
+	/*
+		 count       .
+		 O( + count * log(count)).
+	*/
+	bool get_top(EProcessRanking ranking, std::size_t count, boost::container::vector<ProcessUsageStruct>& top) {
+		if (!generation) return false;
+		if (count > usage.size()) count = usage.size();
+
+		switch (ranking) {
+		case eRankCpuLoad:
+			select_top(count, top, cpu_load_greater());
+			return true;
+		case eRankResident:
+			select_top(count, top, resident_greater());
+			return true;
+		case eRankResidentGrowth:
+			select_top(count, top, resident_growth_greater());
+			return true;
+		}
+
+		return false;
+	}
+
+	/*
+		  (comm)    ProcessUsageStruct::NameId
+	*/
+	const char* get_process_name(unsigned long name_id) const {
+		return process_names.get(name_id);
+	}
+};
+
+}}}}
+#endif
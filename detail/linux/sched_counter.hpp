@@ -0,0 +1,266 @@
+#ifndef BOOST_SCHED_COUNTER_LINUX_HPP
+#define BOOST_SCHED_COUNTER_LINUX_HPP
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <time.h>
+#include <unistd.h>
+#include <boost/cstdint.hpp>
+#include <boost/container/vector.hpp>
+#include "proc_file.hpp"
+
+namespace boost { namespace perfomance { namespace detail { namespace linux_ {
+
+enum EPressureResource {
+	ePressureCpu = 0,
+	ePressureMemory,
+	ePressureIo,
+	ePressureResourceCount
+};
+
+/*
+	PSI:  ,      (some)    (full)  
+*/
+typedef struct {
+	float Some10;							//     10, 60  300 , 
+	float Some60;
+	float Some300;
+	float Full10;
+	float Full60;
+	float Full300;
+	float SomeFraction;						//     
+	float FullFraction;
+	unsigned long long SomeStallMicroseconds;	//  total   
+	unsigned long long FullStallMicroseconds;
+} PressureStruct;
+
+/*
+	       
+*/
+typedef struct {
+	unsigned long long RunTime;				//   
+	unsigned long long RunDelay;			//     , 
+	unsigned long long Timeslices;			//   
+	float RunQueueLength;					//     (RunDelay / )
+	double AverageDelay;					//     , 
+} CoreSchedulerStruct;
+
+/*
+	 :        /proc/schedstat
+	 PSI  /proc/pressure/{cpu,memory,io}.    cpu_counter 
+	  ,   ,    -  ,   
+	 .     thread_counter.
+
+	  -      . /proc/schedstat
+	     CONFIG_SCHEDSTATS, PSI -   4.20 (   
+	 psi=0),      false.
+*/
+class sched_counter {
+private:
+	typedef struct {
+		unsigned long long SomeTotal;
+		unsigned long long FullTotal;
+		boost::uint64_t Timestamp;
+	} PressureStateStruct;
+
+	unsigned long cpu_count;
+	proc_file schedstat_file;
+	proc_file pressure_files[ePressureResourceCount];
+	PressureStateStruct pressure_state[ePressureResourceCount];
+
+	boost::container::vector<unsigned long long> run_time;
+	boost::container::vector<unsigned long long> run_delay;
+	boost::container::vector<unsigned long long> timeslices;
+	boost::container::vector<unsigned long long> prev_run_time;
+	boost::container::vector<unsigned long long> prev_run_delay;
+	boost::container::vector<unsigned long long> prev_timeslices;
+	boost::uint64_t schedstat_timestamp;
+
+	sched_counter(const sched_counter&);
+	sched_counter& operator=(const sched_counter&);
+
+	static boost::uint64_t steady_nanoseconds() {
+		timespec now;
+		::clock_gettime(CLOCK_MONOTONIC, &now);
+		return (boost::uint64_t)now.tv_sec * 1000000000ull + (boost::uint64_t)now.tv_nsec;
+	}
+
+	/*
+		"some avg10=0.12 avg60=0.05 avg300=0.01 total=123456"
+	*/
+	static bool parse_pressure_line(text_scanner& scanner, float* averages, unsigned long long& total) {
+		static const char* const prefixes[] = { "avg10=", "avg60=", "avg300=" };
+		static const std::size_t prefix_sizes[] = { 6, 6, 7 };
+
+		for (int i = 0; i < 3; i++) {
+			double average = 0.0;
+			scanner.skip_spaces();
+			if (!scanner.skip_prefix(prefixes[i], prefix_sizes[i]) || !scanner.parse(average)) return false;
+			averages[i] = (float)average;
+		}
+
+		scanner.skip_spaces();
+		return scanner.skip_prefix("total=", 6) && scanner.parse(total);
+	}
+
+	/*
+		 "cpu<N> yld_count 0 schedule_count goidle ttwu ttwu_local rq_cpu_time run_delay pcount",
+		   domain,  
+	*/
+	bool read_schedstat() {
+		if (!schedstat_file.read()) return false;
+
+		text_scanner scanner(schedstat_file);
+		bool found = false;
+
+		while (scanner.find_line("cpu", 3)) {
+			unsigned long long cpu_index = 0;
+			unsigned long long fields[9];
+
+			if (!scanner.parse(cpu_index)) return false;
+			for (int i = 0; i < 9; i++) {
+				if (!scanner.parse(fields[i])) return false;
+			}
+
+			if (cpu_index < cpu_count) {
+				run_time[cpu_index] = fields[6];
+				run_delay[cpu_index] = fields[7];
+				timeslices[cpu_index] = fields[8];
+				found = true;
+			}
+
+			scanner.next_line();
+		}
+
+		return found;
+	}
+
+	void open(const char* schedstat_path, const char* pressure_directory) {
+		std::memset(pressure_state, 0, sizeof(pressure_state));
+
+		static const char* const pressure_names[] = { "cpu", "memory", "io" };
+		for (int i = 0; i < ePressureResourceCount; i++) {
+			char path[256];
+			std::snprintf(path, sizeof(path), "%s/%s", pressure_directory, pressure_names[i]);
+			pressure_files[i].open(path, 256);
+		}
+
+		run_time.resize(cpu_count);
+		run_delay.resize(cpu_count);
+		timeslices.resize(cpu_count);
+
+		if (schedstat_file.open(schedstat_path, 4096 + cpu_count * 512) && read_schedstat()) {
+			prev_run_time = run_time;
+			prev_run_delay = run_delay;
+			prev_timeslices = timeslices;
+			schedstat_timestamp = steady_nanoseconds();
+		}
+	}
+
+public:
+	sched_counter() : schedstat_timestamp(0) {
+		long configured_count = ::sysconf(_SC_NPROCESSORS_CONF);
+		cpu_count = configured_count > 0 ? (unsigned long)configured_count : 1;
+		open("/proc/schedstat", "/proc/pressure");
+	}
+
+	/*
+		      /proc/schedstat  /proc/pressure,
+		     
+	*/
+	sched_counter(const char* schedstat_path, const char* pressure_directory, unsigned long core_count) : schedstat_timestamp(0) {
+		cpu_count = core_count ? core_count : 1;
+		open(schedstat_path, pressure_directory);
+	}
+
+	unsigned long get_cpu_count() const {
+		return cpu_count;
+	}
+
+	bool has_pressure() const {
+		return pressure_files[ePressureCpu].is_open();
+	}
+
+	bool has_core_latency() const {
+		return schedstat_timestamp != 0;
+	}
+
+	/*
+		  . SomeFraction  FullFraction    total
+		      ,      .
+		 full      ,    .
+	*/
+	bool get_pressure(EPressureResource resource, PressureStruct& pressure) {
+		if (resource >= ePressureResourceCount || !pressure_files[resource].read_head()) return false;
+
+		boost::uint64_t timestamp = steady_nanoseconds();
+		text_scanner scanner(pressure_files[resource]);
+		float averages[3] = {};
+		unsigned long long some_total = 0;
+		unsigned long long full_total = 0;
+
+		if (!scanner.skip_prefix("some", 4) || !parse_pressure_line(scanner, averages, some_total)) return false;
+		pressure.Some10 = averages[0];
+		pressure.Some60 = averages[1];
+		pressure.Some300 = averages[2];
+
+		averages[0] = averages[1] = averages[2] = 0.f;
+		scanner.next_line();
+		if (scanner.skip_prefix("full", 4)) parse_pressure_line(scanner, averages, full_total);
+		pressure.Full10 = averages[0];
+		pressure.Full60 = averages[1];
+		pressure.Full300 = averages[2];
+
+		PressureStateStruct& state = pressure_state[resource];
+		pressure.SomeStallMicroseconds = state.Timestamp && some_total > state.SomeTotal ? some_total - state.SomeTotal : 0;
+		pressure.FullStallMicroseconds = state.Timestamp && full_total > state.FullTotal ? full_total - state.FullTotal : 0;
+		pressure.SomeFraction = 0.f;
+		pressure.FullFraction = 0.f;
+
+		if (state.Timestamp && timestamp > state.Timestamp) {
+			double elapsed_microseconds = (double)(timestamp - state.Timestamp) * 1e-3;
+			pressure.SomeFraction = (float)((double)pressure.SomeStallMicroseconds / elapsed_microseconds);
+			pressure.FullFraction = (float)((double)pressure.FullStallMicroseconds / elapsed_microseconds);
+		}
+
+		state.SomeTotal = some_total;
+		state.FullTotal = full_total;
+		state.Timestamp = timestamp;
+		return true;
+	}
+
+	/*
+		       ,    
+		  cpu_counter::get_load_per_core
+	*/
+	bool get_core_latency(boost::container::vector<CoreSchedulerStruct>& core_latency) {
+		if (!schedstat_timestamp || !read_schedstat()) return false;
+
+		boost::uint64_t timestamp = steady_nanoseconds();
+		double elapsed = timestamp > schedstat_timestamp ? (double)(timestamp - schedstat_timestamp) : 0.0;
+
+		core_latency.resize(cpu_count);
+		for (unsigned long i = 0; i < cpu_count; i++) {
+			CoreSchedulerStruct& core = core_latency[i];
+			core.RunTime = run_time[i] - prev_run_time[i];
+			core.RunDelay = run_delay[i] - prev_run_delay[i];
+			core.Timeslices = timeslices[i] - prev_timeslices[i];
+			core.RunQueueLength = elapsed > 0 ? (float)((double)core.RunDelay / elapsed) : 0.f;
+			core.AverageDelay = core.Timeslices ? (double)core.RunDelay / (double)core.Timeslices : 0.0;
+		}
+
+		prev_run_time = run_time;
+		prev_run_delay = run_delay;
+		prev_timeslices = timeslices;
+		schedstat_timestamp = timestamp;
+		return true;
+	}
+};
+
+}}}}
+#endif
@@ -0,0 +1,297 @@
+#ifndef BOOST_SOCKET_INDEX_LINUX_HPP
+#define BOOST_SOCKET_INDEX_LINUX_HPP
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <boost/cstdint.hpp>
+#include "../open_hash_map.hpp"
+#include "../string_table.hpp"
+#include "descriptor_cache.hpp"
+#include "proc_directory.hpp"
+#include "proc_file.hpp"
+
+namespace boost { namespace perfomance { namespace detail { namespace linux_ {
+
+/*
+	 inode  -> PID ,     .  
+	/proc/<pid>/fd  O( * )  readlink,  
+	          ,
+	     .
+
+	       :    
+	,    ,   ,    
+	    .    , 
+	    .
+
+	       /proc/<pid>/stat    (
+	pread   ):      
+	   PID,    ,    - exec.
+*/
+class socket_process_index {
+private:
+	typedef struct {
+		int StatFd;
+		unsigned long FdCount;
+		unsigned long SocketCount;
+		unsigned long NameId;
+		unsigned long ScanId;
+		unsigned long Generation;
+		unsigned long long StartTime;
+	} ProcessEntryStruct;
+
+	typedef struct {
+		unsigned long ProcessID;
+		unsigned long ScanId;
+	} SocketOwnerStruct;
+
+	enum : unsigned long {
+		unknown_fd_count = ~0ul
+	};
+
+	int proc_fd;
+	proc_directory process_directory;
+	proc_directory fd_directory;
+
+	descriptor_cache descriptors;
+	open_hash_map<ProcessEntryStruct> processes;
+	open_hash_map<SocketOwnerStruct> sockets;
+	string_table process_names;
+	char stat_buffer[1024];
+
+	unsigned long generation;
+	unsigned long scan_counter;
+	std::size_t stale_sockets;
+
+	socket_process_index(const socket_process_index&);
+	socket_process_index& operator=(const socket_process_index&);
+
+	struct dead_process {
+		unsigned long current_generation;
+		std::size_t& stale_sockets;
+		descriptor_cache& descriptors;
+
+		dead_process(unsigned long generation_value, std::size_t& stale, descriptor_cache& cache)
+			: current_generation(generation_value), stale_sockets(stale), descriptors(cache) {}
+
+		bool operator()(boost::uint64_t, ProcessEntryStruct& process) {
+			if (process.Generation == current_generation) return false;
+			stale_sockets += process.SocketCount;
+			descriptors.release(process.StatFd);
+			return true;
+		}
+	};
+
+	struct close_process {
+		descriptor_cache& descriptors;
+
+		explicit close_process(descriptor_cache& cache) : descriptors(cache) {}
+
+		void operator()(boost::uint64_t, ProcessEntryStruct& process) {
+			descriptors.release(process.StatFd);
+		}
+	};
+
+	struct stale_socket {
+		open_hash_map<ProcessEntryStruct>& processes;
+
+		explicit stale_socket(open_hash_map<ProcessEntryStruct>& process_map) : processes(process_map) {}
+
+		bool operator()(boost::uint64_t, const SocketOwnerStruct& owner) {
+			const ProcessEntryStruct* process = processes.find(owner.ProcessID);
+			return !process || process->ScanId != owner.ScanId;
+		}
+	};
+
+	/*
+		  starttime ( 22)  /proc/<pid>/stat.    
+		 ,        .
+	*/
+	bool read_process_stat(unsigned long pid, ProcessEntryStruct& process, unsigned long long& start_time, const char*& name, std::size_t& name_size) {
+		ssize_t read_size = descriptors.read(process.StatFd, stat_buffer, sizeof(stat_buffer));
+		if (read_size < 0) {
+			char path[32];
+			std::snprintf(path, sizeof(path), "%lu/stat", pid);
+			read_size = descriptors.open_read(proc_fd, path, process.StatFd, stat_buffer, sizeof(stat_buffer));
+		}
+
+		if (read_size <= 0) return false;
+
+		const char* name_begin = (const char*)std::memchr(stat_buffer, '(', (std::size_t)read_size);
+		const char* name_end = (const char*)::memrchr(stat_buffer, ')', (std::size_t)read_size);
+		if (!name_begin || !name_end || name_end < name_begin) return false;
+
+		name = name_begin + 1;
+		name_size = (std::size_t)(name_end - name_begin - 1);
+
+		text_scanner scanner(name_end + 1, stat_buffer + read_size);
+		for (int i = 3; i <= 21; i++) scanner.skip_token();
+		return scanner.parse(start_time);
+	}
+
+	void refresh_process_name(const char* name, std::size_t name_size, ProcessEntryStruct& process) {
+		const char* current_name = process_names.get(process.NameId);
+		if (process.NameId && std::strlen(current_name) == name_size && !std::memcmp(current_name, name, name_size)) return;
+
+		process.NameId = process_names.intern(name, name_size);
+	}
+
+	/*
+		  .   Linux 6.2   stat  
+		fd,    st_size      .
+	*/
+	unsigned long count_descriptors() {
+		struct stat fd_stat;
+		if (::fstat(fd_directory.native_handle(), &fd_stat) == 0 && fd_stat.st_size > 0) {
+			return (unsigned long)fd_stat.st_size;
+		}
+
+		unsigned long ret_value = 0;
+		while (fd_directory.next()) {
+			ret_value++;
+		}
+
+		fd_directory.rewind();
+		return ret_value;
+	}
+
+	void scan_descriptors(unsigned long pid, ProcessEntryStruct& process) {
+		char link[64];
+		unsigned long socket_count = 0;
+
+		stale_sockets += process.SocketCount;
+		process.ScanId = ++scan_counter;
+
+		const char* name = NULL;
+		while ((name = fd_directory.next()) != NULL) {
+			ssize_t link_size = ::readlinkat(fd_directory.native_handle(), name, link, sizeof(link) - 1);
+			if (link_size < 9 || std::memcmp(link, "socket:[", 8)) continue;
+
+			unsigned long inode = 0;
+			for (ssize_t i = 8; i < link_size && link[i] >= '0' && link[i] <= '9'; i++) {
+				inode = inode * 10 + (unsigned long)(link[i] - '0');
+			}
+
+			SocketOwnerStruct& owner = sockets[inode];
+			owner.ProcessID = pid;
+			owner.ScanId = process.ScanId;
+			socket_count++;
+		}
+
+		process.SocketCount = socket_count;
+	}
+
+	void refresh_process(unsigned long pid) {
+		bool inserted = false;
+		ProcessEntryStruct& process = processes.insert(pid, inserted);
+		process.Generation = generation;
+
+		if (inserted) {
+			process.StatFd = -1;
+			process.FdCount = unknown_fd_count;
+		}
+
+		unsigned long long start_time = 0;
+		const char* name = NULL;
+		std::size_t name_size = 0;
+		if (read_process_stat(pid, process, start_time, name, name_size)) {
+			if (!inserted && start_time != process.StartTime) process.FdCount = unknown_fd_count;
+
+			process.StartTime = start_time;
+			refresh_process_name(name, name_size, process);
+		}
+
+		char path[32];
+		std::snprintf(path, sizeof(path), "%lu/fd", pid);
+
+		/*
+			    CAP_SYS_PTRACE ,  
+			   
+		*/
+		if (!fd_directory.open(path, proc_fd)) return;
+
+		unsigned long fd_count = count_descriptors();
+		if (fd_count != process.FdCount) {
+			process.FdCount = fd_count;
+			scan_descriptors(pid, process);
+		}
+
+		fd_directory.close();
+	}
+
+public:
+	socket_process_index() : proc_fd(-1), fd_directory(4096), generation(0), scan_counter(0), stale_sockets(0) {
+		if (process_directory.open("/proc")) proc_fd = process_directory.native_handle();
+	}
+
+	~socket_process_index() {
+		close_process functor(descriptors);
+		processes.for_each(functor);
+	}
+
+	/*
+		       ,  -
+		. ,   ,     .
+	*/
+	bool refresh() {
+		if (proc_fd < 0 || !process_directory.rewind()) return false;
+
+		generation++;
+		std::size_t alive_count = 0;
+
+		const char* name = NULL;
+		while ((name = process_directory.next()) != NULL) {
+			unsigned long pid = 0;
+			if (!proc_directory::parse_number(name, pid)) continue;
+
+			refresh_process(pid);
+			alive_count++;
+		}
+
+		if (alive_count != processes.size()) {
+			dead_process predicate(generation, stale_sockets, descriptors);
+			processes.erase_if(predicate);
+		}
+
+		if (stale_sockets > 1024 && stale_sockets * 2 > sockets.size()) {
+			stale_socket predicate(processes);
+			sockets.erase_if(predicate);
+			stale_sockets = 0;
+		}
+
+		return true;
+	}
+
+	/*
+		   inode. name_id -      
+	*/
+	bool find(unsigned long inode, unsigned long& pid, unsigned long& name_id) const {
+		const SocketOwnerStruct* owner = sockets.find(inode);
+		if (!owner) return false;
+
+		const ProcessEntryStruct* process = processes.find(owner->ProcessID);
+		if (!process || process->ScanId != owner->ScanId) return false;
+
+		pid = owner->ProcessID;
+		name_id = process->NameId;
+		return true;
+	}
+
+	/*
+		  (comm)    find.     refresh
+	*/
+	const char* get_process_name(unsigned long name_id) const {
+		return process_names.get(name_id);
+	}
+};
+
+}}}}
+#endif
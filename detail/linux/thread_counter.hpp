@@ -0,0 +1,393 @@
+#ifndef BOOST_THREAD_COUNTER_LINUX_HPP
+#define BOOST_THREAD_COUNTER_LINUX_HPP
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <dirent.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <boost/cstdint.hpp>
+#include <boost/container/vector.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/lock_guard.hpp>
+#include "../open_hash_map.hpp"
+#include "../string_table.hpp"
+#include "descriptor_cache.hpp"
+#include "proc_directory.hpp"
+#include "proc_file.hpp"
+
+namespace boost { namespace perfomance { namespace detail { namespace linux_ {
+
+typedef struct {
+	unsigned long ThreadID;
+	unsigned long NameId;					//    get_thread_name
+	unsigned long LastCpu;					// ,     
+	bool Registered;						//      
+	float CpuLoad;							//     , 0   
+	float SystemLoad;						//      (   )
+	unsigned long long CpuTime;				//      
+	unsigned long long UserTime;			// ,    
+	unsigned long long SystemTime;
+	unsigned long long RunQueueTime;		//       
+	unsigned long long RunQueueDelay;		//     
+	double AverageRunQueueDelay;			//        , 
+	unsigned long long VoluntarySwitches;	//     ( -, )
+	unsigned long long InvoluntarySwitches;	//   
+	double VoluntarySwitchRate;				//     
+	double InvoluntarySwitchRate;
+} ThreadUsageStruct;
+
+/*
+	     (  ).   
+	 /proc/<pid>/task/<tid>/stat ( user  system,  ),
+	schedstat (       )  status (
+	).       .
+
+	      register_current_thread,
+	      clock_gettime(pthread_getcpuclockid),  
+	     .
+*/
+class thread_counter {
+private:
+	typedef struct {
+		int StatFd;
+		int SchedstatFd;
+		int StatusFd;
+		unsigned long Generation;
+		unsigned long NameId;
+		unsigned long long StartTime;
+		unsigned long long CpuTime;
+		unsigned long long SystemTicks;
+		unsigned long long RunQueueTime;
+		unsigned long long Timeslices;
+		unsigned long long VoluntarySwitches;
+		unsigned long long InvoluntarySwitches;
+	} ThreadStateStruct;
+
+	typedef struct {
+		clockid_t ClockId;
+		unsigned long Generation;
+		char Name[32];
+	} RegisteredThreadStruct;
+
+	typedef struct {
+		unsigned long long UserTicks;
+		unsigned long long SystemTicks;
+		unsigned long long StartTime;
+		unsigned long long LastCpu;
+		const char* Name;
+		std::size_t NameSize;
+	} StatFieldsStruct;
+
+	int task_fd;
+	bool is_current_process;
+	proc_directory task_directory;
+	descriptor_cache descriptors;
+	open_hash_map<ThreadStateStruct> threads;
+	string_table thread_names;
+	boost::container::vector<ThreadUsageStruct> usage;
+
+	boost::mutex registration_mutex;
+	open_hash_map<RegisteredThreadStruct> registered_threads;
+
+	unsigned long generation;
+	std::size_t registered_seen;
+	boost::uint64_t timestamp;
+	double nanoseconds_per_tick;
+	char read_buffer[4096];
+
+	thread_counter(const thread_counter&);
+	thread_counter& operator=(const thread_counter&);
+
+	struct dead_thread {
+		unsigned long current_generation;
+		descriptor_cache& descriptors;
+
+		dead_thread(unsigned long generation_value, descriptor_cache& cache) : current_generation(generation_value), descriptors(cache) {}
+
+		bool operator()(boost::uint64_t, ThreadStateStruct& thread) {
+			if (thread.Generation == current_generation) return false;
+			descriptors.release(thread.StatFd);
+			descriptors.release(thread.SchedstatFd);
+			descriptors.release(thread.StatusFd);
+			return true;
+		}
+
+		bool operator()(boost::uint64_t, const RegisteredThreadStruct& thread) {
+			return thread.Generation != current_generation;
+		}
+	};
+
+	struct close_thread {
+		descriptor_cache& descriptors;
+
+		explicit close_thread(descriptor_cache& cache) : descriptors(cache) {}
+
+		void operator()(boost::uint64_t, ThreadStateStruct& thread) {
+			descriptors.release(thread.StatFd);
+			descriptors.release(thread.SchedstatFd);
+			descriptors.release(thread.StatusFd);
+		}
+	};
+
+	static boost::uint64_t steady_nanoseconds() {
+		timespec now;
+		::clock_gettime(CLOCK_MONOTONIC, &now);
+		return (boost::uint64_t)now.tv_sec * 1000000000ull + (boost::uint64_t)now.tv_nsec;
+	}
+
+	static unsigned long current_thread_id() {
+		return (unsigned long)::syscall(SYS_gettid);
+	}
+
+	/*
+		      : state (3), ... utime (14),
+		stime (15), ... starttime (22), ... processor (39)
+	*/
+	static bool parse_stat(const char* data, std::size_t size, StatFieldsStruct& fields) {
+		const char* name_begin = (const char*)std::memchr(data, '(', size);
+		const char* name_end = (const char*)::memrchr(data, ')', size);
+		if (!name_begin || !name_end || name_end < name_begin) return false;
+
+		fields.Name = name_begin + 1;
+		fields.NameSize = (std::size_t)(name_end - name_begin - 1);
+
+		text_scanner scanner(name_end + 1, data + size);
+		for (int i = 3; i <= 13; i++) scanner.skip_token();
+		if (!scanner.parse(fields.UserTicks) || !scanner.parse(fields.SystemTicks)) return false;
+		for (int i = 16; i <= 21; i++) scanner.skip_token();
+		if (!scanner.parse(fields.StartTime)) return false;
+		for (int i = 23; i <= 38; i++) scanner.skip_token();
+		return scanner.parse(fields.LastCpu);
+	}
+
+	ssize_t read_task_file(unsigned long tid, const char* name, int& fd) {
+		ssize_t read_size = descriptors.read(fd, read_buffer, sizeof(read_buffer));
+		if (read_size >= 0) return read_size;
+
+		char path[48];
+		std::snprintf(path, sizeof(path), "%lu/%s", tid, name);
+		return descriptors.open_read(task_fd, path, fd, read_buffer, sizeof(read_buffer));
+	}
+
+	/*
+		schedstat:          , 
+		 .  ,     CONFIG_SCHED_INFO.
+	*/
+	bool read_schedstat(unsigned long tid, ThreadStateStruct& thread, unsigned long long& run_time, unsigned long long& wait_time, unsigned long long& slices) {
+		ssize_t read_size = read_task_file(tid, "schedstat", thread.SchedstatFd);
+		if (read_size <= 0) return false;
+
+		text_scanner scanner(read_buffer, read_buffer + read_size);
+		return scanner.parse(run_time) && scanner.parse(wait_time) && scanner.parse(slices);
+	}
+
+	bool read_switches(unsigned long tid, ThreadStateStruct& thread, unsigned long long& voluntary, unsigned long long& involuntary) {
+		ssize_t read_size = read_task_file(tid, "status", thread.StatusFd);
+		if (read_size <= 0) return false;
+
+		text_scanner scanner(read_buffer, read_buffer + read_size);
+		if (!scanner.find_line("voluntary_ctxt_switches:", 24) || !scanner.parse(voluntary)) return false;
+		return scanner.find_line("nonvoluntary_ctxt_switches:", 27) && scanner.parse(involuntary);
+	}
+
+	void refresh_thread(unsigned long tid, double elapsed_seconds) {
+		bool inserted = false;
+		ThreadStateStruct& thread = threads.insert(tid, inserted);
+		thread.Generation = generation;
+		if (inserted) {
+			thread.StatFd = -1;
+			thread.SchedstatFd = -1;
+			thread.StatusFd = -1;
+		}
+
+		StatFieldsStruct fields;
+		ssize_t read_size = read_task_file(tid, "stat", thread.StatFd);
+		if (read_size <= 0 || !parse_stat(read_buffer, (std::size_t)read_size, fields)) return;
+
+		/*
+			    ,      
+		*/
+		bool is_new = inserted || thread.StartTime != fields.StartTime;
+		if (is_new) thread.NameId = thread_names.intern(fields.Name, fields.NameSize);
+
+		RegisteredThreadStruct* registered = is_current_process ? registered_threads.find(tid) : NULL;
+
+		ThreadUsageStruct row;
+		row.ThreadID = tid;
+		row.LastCpu = (unsigned long)fields.LastCpu;
+		row.Registered = false;
+		row.UserTime = (unsigned long long)((double)fields.UserTicks * nanoseconds_per_tick);
+		row.SystemTime = (unsigned long long)((double)fields.SystemTicks * nanoseconds_per_tick);
+		row.RunQueueTime = 0;
+		row.CpuTime = row.UserTime + row.SystemTime;
+		row.VoluntarySwitches = 0;
+		row.InvoluntarySwitches = 0;
+
+		unsigned long long run_time = 0;
+		unsigned long long slices = 0;
+		if (read_schedstat(tid, thread, run_time, row.RunQueueTime, slices)) row.CpuTime = run_time;
+
+		if (registered) {
+			registered->Generation = generation;
+			registered_seen++;
+
+			timespec cpu_time;
+			if (!::clock_gettime(registered->ClockId, &cpu_time)) {
+				row.CpuTime = (unsigned long long)cpu_time.tv_sec * 1000000000ull + (unsigned long long)cpu_time.tv_nsec;
+				row.Registered = true;
+			}
+		}
+
+		read_switches(tid, thread, row.VoluntarySwitches, row.InvoluntarySwitches);
+
+		if (is_new) {
+			thread.StartTime = fields.StartTime;
+			thread.CpuTime = row.CpuTime;
+			thread.SystemTicks = fields.SystemTicks;
+			thread.RunQueueTime = row.RunQueueTime;
+			thread.Timeslices = slices;
+			thread.VoluntarySwitches = row.VoluntarySwitches;
+			thread.InvoluntarySwitches = row.InvoluntarySwitches;
+		}
+
+		row.NameId = registered && registered->Name[0] ? thread_names.intern(registered->Name, std::strlen(registered->Name)) : thread.NameId;
+
+		/*
+			       schedstat,  
+			,    
+		*/
+		double elapsed_nanoseconds = elapsed_seconds * 1e9;
+		row.CpuLoad = elapsed_seconds > 0 && row.CpuTime > thread.CpuTime ? (float)((double)(row.CpuTime - thread.CpuTime) / elapsed_nanoseconds) : 0.f;
+		row.SystemLoad = elapsed_seconds > 0 ? (float)((double)(fields.SystemTicks - thread.SystemTicks) * nanoseconds_per_tick / elapsed_nanoseconds) : 0.f;
+		row.RunQueueDelay = row.RunQueueTime > thread.RunQueueTime ? row.RunQueueTime - thread.RunQueueTime : 0;
+		row.AverageRunQueueDelay = slices > thread.Timeslices ? (double)row.RunQueueDelay / (double)(slices - thread.Timeslices) : 0.0;
+		row.VoluntarySwitchRate = elapsed_seconds > 0 ? (double)(row.VoluntarySwitches - thread.VoluntarySwitches) / elapsed_seconds : 0.0;
+		row.InvoluntarySwitchRate = elapsed_seconds > 0 ? (double)(row.InvoluntarySwitches - thread.InvoluntarySwitches) / elapsed_seconds : 0.0;
+		usage.push_back(row);
+
+		if (row.CpuTime > thread.CpuTime) thread.CpuTime = row.CpuTime;
+		thread.SystemTicks = fields.SystemTicks;
+		thread.RunQueueTime = row.RunQueueTime;
+		thread.Timeslices = slices;
+		thread.VoluntarySwitches = row.VoluntarySwitches;
+		thread.InvoluntarySwitches = row.InvoluntarySwitches;
+	}
+
+public:
+	/*
+		process_id == 0 -  
+	*/
+	explicit thread_counter(int process_id = 0) : task_fd(-1), is_current_process(!process_id || process_id == (int)::getpid()),
+		task_directory(8192), generation(0), registered_seen(0), timestamp(0) {
+		long ticks_per_second = ::sysconf(_SC_CLK_TCK);
+		nanoseconds_per_tick = 1e9 / (ticks_per_second > 0 ? (double)ticks_per_second : 100.0);
+
+		char path[32];
+		if (is_current_process) {
+			std::strcpy(path, "/proc/self/task");
+		} else {
+			std::snprintf(path, sizeof(path), "/proc/%d/task", process_id);
+		}
+
+		if (task_directory.open(path)) task_fd = task_directory.native_handle();
+	}
+
+	~thread_counter() {
+		close_thread functor(descriptors);
+		threads.for_each(functor);
+	}
+
+	bool is_open() const {
+		return task_fd >= 0;
+	}
+
+	/*
+		  :        ,
+		 name ( 31 )    comm.  
+		   .     .
+	*/
+	bool register_current_thread(const char* name = NULL) {
+		if (!is_current_process) return false;
+
+		RegisteredThreadStruct thread;
+		if (::pthread_getcpuclockid(::pthread_self(), &thread.ClockId)) return false;
+
+		thread.Name[0] = 0;
+		if (name) {
+			std::strncpy(thread.Name, name, sizeof(thread.Name) - 1);
+			thread.Name[sizeof(thread.Name) - 1] = 0;
+		}
+
+		boost::lock_guard<boost::mutex> lock(registration_mutex);
+		thread.Generation = generation;
+		registered_threads[current_thread_id()] = thread;
+		return true;
+	}
+
+	void unregister_current_thread() {
+		boost::lock_guard<boost::mutex> lock(registration_mutex);
+		registered_threads.erase(current_thread_id());
+	}
+
+	/*
+		  .      
+		 .  false,   .
+	*/
+	bool refresh() {
+		if (task_fd < 0 || !task_directory.rewind()) return false;
+
+		boost::lock_guard<boost::mutex> lock(registration_mutex);
+
+		boost::uint64_t now = steady_nanoseconds();
+		double elapsed_seconds = timestamp && now > timestamp ? (double)(now - timestamp) * 1e-9 : 0.0;
+
+		generation++;
+		registered_seen = 0;
+		timestamp = now;
+		usage.clear();
+
+		std::size_t listed_count = 0;
+		const char* name = NULL;
+		unsigned char type = 0;
+
+		while ((name = task_directory.next(&type)) != NULL) {
+			unsigned long tid = 0;
+			if ((type != DT_DIR && type != DT_UNKNOWN) || !proc_directory::parse_number(name, tid)) continue;
+
+			refresh_thread(tid, elapsed_seconds);
+			listed_count++;
+		}
+
+		dead_thread predicate(generation, descriptors);
+		if (listed_count != threads.size()) threads.erase_if(predicate);
+		if (registered_seen != registered_threads.size()) registered_threads.erase_if(predicate);
+
+		return listed_count != 0;
+	}
+
+	/*
+		      task
+	*/
+	const boost::container::vector<ThreadUsageStruct>& get_threads() const {
+		return usage;
+	}
+
+	std::size_t get_thread_count() const {
+		return usage.size();
+	}
+
+	const char* get_thread_name(unsigned long name_id) const {
+		return thread_names.get(name_id);
+	}
+};
+
+}}}}
+#endif
@@ -0,0 +1,332 @@
+#ifndef BOOST_TOPOLOGY_LINUX_HPP
+#define BOOST_TOPOLOGY_LINUX_HPP
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <cstdlib>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+#include <boost/cstdint.hpp>
+#include <boost/container/vector.hpp>
+#include <boost/container/flat_map.hpp>
+#include "proc_file.hpp"
+#include "proc_directory.hpp"
+
+namespace boost { namespace perfomance { namespace detail { namespace linux_ {
+
+enum ETopologyLevel {
+	eTopologyCore = 0,		//   ( SMT )
+	eTopologyCache,			//     
+	eTopologyPackage,		//  
+	eTopologyNode,			// NUMA 
+	eTopologyLevelCount
+};
+
+/*
+	 ,     /sys/devices/system/cpu 
+	/sys/devices/system/node.       
+	   ,     -    
+	 .        .
+*/
+class cpu_topology {
+public:
+	enum : unsigned long {
+		invalid_domain = ~0ul
+	};
+
+private:
+	std::size_t cpu_count;
+	boost::container::vector<unsigned long> cpu_domains[eTopologyLevelCount];
+	boost::container::vector<unsigned long> domain_sizes[eTopologyLevelCount];
+	boost::container::vector<unsigned long> node_ids;
+	boost::container::vector<proc_file> node_meminfo_files;
+
+	cpu_topology(const cpu_topology&);
+	cpu_topology& operator=(const cpu_topology&);
+
+	static bool read_number(const char* path, unsigned long long& value) {
+		proc_file file(path, 256);
+		if (!file.read_head()) return false;
+
+		text_scanner scanner(file);
+		return scanner.parse(value);
+	}
+
+	/*
+		     "0-3,8-11".    :
+		  ,    ,  .
+	*/
+	static bool read_first_cpu(const char* path, unsigned long long& value) {
+		return read_number(path, value);
+	}
+
+	/*
+		 functor(cpu)       "0-3,8-11"
+	*/
+	template <class Functor>
+	static bool for_each_in_cpulist(const char* path, Functor& functor) {
+		proc_file file(path, 1024);
+		if (!file.read()) return false;
+
+		text_scanner scanner(file);
+		unsigned long long first = 0;
+		while (scanner.parse(first)) {
+			unsigned long long last = first;
+			if (scanner.skip_prefix("-", 1) && !scanner.parse(last)) return false;
+
+			for (unsigned long long cpu = first; cpu <= last; cpu++) {
+				functor((std::size_t)cpu);
+			}
+
+			if (!scanner.skip_prefix(",", 1)) break;
+		}
+
+		return true;
+	}
+
+	/*
+		  :    level     
+	*/
+	static bool find_llc_key(std::size_t cpu, unsigned long long& key) {
+		char path[128];
+		unsigned long long best_level = 0;
+		bool found = false;
+
+		for (unsigned int index = 0;; index++) {
+			unsigned long long level = 0;
+			std::snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%zu/cache/index%u/level", cpu, index);
+			if (!read_number(path, level)) break;
+
+			std::snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%zu/cache/index%u/type", cpu, index);
+			proc_file type_file(path, 64);
+			if (!type_file.read_head() || text_scanner(type_file).starts_with("Instruction", 11)) continue;
+
+			std::snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%zu/cache/index%u/shared_cpu_list", cpu, index);
+			unsigned long long first_cpu = 0;
+			if (level > best_level && read_first_cpu(path, first_cpu)) {
+				best_level = level;
+				key = first_cpu;
+				found = true;
+			}
+		}
+
+		return found;
+	}
+
+	/*
+		   ( ,   )  
+		 0..N-1   
+	*/
+	static unsigned long dense_index(boost::container::flat_map<unsigned long long, unsigned long>& keys, unsigned long long key) {
+		boost::container::flat_map<unsigned long long, unsigned long>::iterator it = keys.find(key);
+		if (it != keys.end()) return it->second;
+
+		unsigned long index = (unsigned long)keys.size();
+		keys[key] = index;
+		return index;
+	}
+
+	struct assign_node {
+		boost::container::vector<unsigned long>& cpu_nodes;
+		unsigned long node;
+
+		assign_node(boost::container::vector<unsigned long>& nodes, unsigned long node_index) : cpu_nodes(nodes), node(node_index) {}
+
+		void operator()(std::size_t cpu) {
+			if (cpu < cpu_nodes.size()) cpu_nodes[cpu] = node;
+		}
+	};
+
+	void load_cpus() {
+		char path[128];
+		boost::container::flat_map<unsigned long long, unsigned long> core_keys;
+		boost::container::flat_map<unsigned long long, unsigned long> cache_keys;
+		boost::container::flat_map<unsigned long long, unsigned long> package_keys;
+
+		for (std::size_t cpu = 0; cpu < cpu_count; cpu++) {
+			unsigned long long package_id = 0;
+			unsigned long long core_key = 0;
+			unsigned long long cache_key = 0;
+
+			std::snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%zu/topology/physical_package_id", cpu);
+			if (!read_number(path, package_id)) continue;
+
+			std::snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%zu/topology/thread_siblings_list", cpu);
+			if (!read_first_cpu(path, core_key)) core_key = cpu;
+
+			/*
+				    (  ),    
+			*/
+			bool has_cache = find_llc_key(cpu, cache_key);
+
+			unsigned long package = dense_index(package_keys, package_id);
+			cpu_domains[eTopologyPackage][cpu] = package;
+			cpu_domains[eTopologyCore][cpu] = dense_index(core_keys, core_key);
+			cpu_domains[eTopologyCache][cpu] = has_cache ? dense_index(cache_keys, cache_key) : invalid_domain;
+		}
+
+		/*
+			      ,     
+		*/
+		for (std::size_t cpu = 0; cpu < cpu_count; cpu++) {
+			if (cpu_domains[eTopologyCache][cpu] == invalid_domain && cpu_domains[eTopologyPackage][cpu] != invalid_domain) {
+				cpu_domains[eTopologyCache][cpu] = dense_index(cache_keys, (1ull << 63) | cpu_domains[eTopologyPackage][cpu]);
+			}
+		}
+	}
+
+	void load_nodes() {
+		proc_directory node_directory(4096);
+		if (node_directory.open("/sys/devices/system/node")) {
+			const char* name = NULL;
+			while ((name = node_directory.next()) != NULL) {
+				unsigned long node_id = 0;
+				if (std::strncmp(name, "node", 4) || !proc_directory::parse_number(name + 4, node_id)) continue;
+				node_ids.push_back(node_id);
+			}
+		}
+
+		/*
+			  CONFIG_NUMA    node,    -  
+		*/
+		if (node_ids.empty()) {
+			node_ids.assign(1, 0);
+			for (std::size_t cpu = 0; cpu < cpu_count; cpu++) {
+				if (cpu_domains[eTopologyPackage][cpu] != invalid_domain) cpu_domains[eTopologyNode][cpu] = 0;
+			}
+
+			return;
+		}
+
+		std::sort(node_ids.begin(), node_ids.end());
+
+		char path[128];
+		for (std::size_t i = 0; i < node_ids.size(); i++) {
+			std::snprintf(path, sizeof(path), "/sys/devices/system/node/node%lu/cpulist", node_ids[i]);
+			assign_node functor(cpu_domains[eTopologyNode], (unsigned long)i);
+			for_each_in_cpulist(path, functor);
+
+			std::snprintf(path, sizeof(path), "/sys/devices/system/node/node%lu/meminfo", node_ids[i]);
+			node_meminfo_files.push_back(proc_file(path));
+		}
+
+		for (std::size_t cpu = 0; cpu < cpu_count; cpu++) {
+			if (cpu_domains[eTopologyPackage][cpu] == invalid_domain) cpu_domains[eTopologyNode][cpu] = invalid_domain;
+		}
+	}
+
+	void count_domains() {
+		for (std::size_t level = 0; level < eTopologyLevelCount; level++) {
+			for (std::size_t cpu = 0; cpu < cpu_count; cpu++) {
+				unsigned long domain = cpu_domains[level][cpu];
+				if (domain == invalid_domain) continue;
+
+				if (domain >= domain_sizes[level].size()) domain_sizes[level].resize(domain + 1, 0);
+				domain_sizes[level][domain]++;
+			}
+		}
+
+		if (domain_sizes[eTopologyNode].size() < node_ids.size()) domain_sizes[eTopologyNode].resize(node_ids.size(), 0);
+	}
+
+public:
+	cpu_topology() : cpu_count(0) {
+		long configured_count = ::sysconf(_SC_NPROCESSORS_CONF);
+		cpu_count = configured_count > 0 ? (std::size_t)configured_count : 1;
+
+		for (std::size_t level = 0; level < eTopologyLevelCount; level++) {
+			cpu_domains[level].resize(cpu_count, invalid_domain);
+		}
+
+		load_cpus();
+		load_nodes();
+		count_domains();
+	}
+
+	std::size_t get_cpu_count() const {
+		return cpu_count;
+	}
+
+	std::size_t get_domain_count(ETopologyLevel level) const {
+		return domain_sizes[level].size();
+	}
+
+	/*
+		     level  invalid_domain   
+	*/
+	unsigned long get_domain(std::size_t cpu, ETopologyLevel level) const {
+		return cpu < cpu_count ? cpu_domains[level][cpu] : (unsigned long)invalid_domain;
+	}
+
+	/*
+		    
+	*/
+	unsigned long get_domain_size(unsigned long domain, ETopologyLevel level) const {
+		return domain < domain_sizes[level].size() ? domain_sizes[level][domain] : 0;
+	}
+
+	/*
+		   /sys/devices/system/node (     )
+	*/
+	unsigned long get_node_id(unsigned long node) const {
+		return node < node_ids.size() ? node_ids[node] : (unsigned long)invalid_domain;
+	}
+
+	/*
+		     level. core_load -   
+		   ,     get_load_per_core.
+	*/
+	bool aggregate_load(const boost::container::vector<float>& core_load, ETopologyLevel level, boost::container::vector<float>& domain_load) const {
+		domain_load.assign(domain_sizes[level].size(), 0.f);
+		if (domain_load.empty()) return false;
+
+		std::size_t count = core_load.size() < cpu_count ? core_load.size() : cpu_count;
+		for (std::size_t cpu = 0; cpu < count; cpu++) {
+			unsigned long domain = cpu_domains[level][cpu];
+			if (domain != invalid_domain) domain_load[domain] += core_load[cpu];
+		}
+
+		for (std::size_t domain = 0; domain < domain_load.size(); domain++) {
+			if (domain_sizes[level][domain]) domain_load[domain] /= (float)domain_sizes[level][domain];
+		}
+
+		return true;
+	}
+
+	/*
+		   NUMA    ("Node N MemFree: X kB"). 
+		     .
+	*/
+	bool get_node_free_memory(boost::container::vector<unsigned long long>& free_memory) {
+		free_memory.assign(node_ids.size(), 0);
+		if (node_meminfo_files.empty()) return false;
+
+		for (std::size_t i = 0; i < node_meminfo_files.size(); i++) {
+			if (!node_meminfo_files[i].read_head()) return false;
+
+			text_scanner scanner(node_meminfo_files[i]);
+			while (!scanner.eof()) {
+				text_scanner line = scanner;
+				scanner.next_line();
+
+				line.skip_token();
+				line.skip_token();
+				line.skip_spaces();
+				if (!line.skip_prefix("MemFree:", 8)) continue;
+
+				unsigned long long value = 0;
+				if (line.parse(value)) free_memory[i] = value * 1024;
+				break;
+			}
+		}
+
+		return true;
+	}
+};
+
+}}}}
+#endif
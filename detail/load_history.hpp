@@ -0,0 +1,256 @@
+#ifndef BOOST_PERFOMANCE_LOAD_HISTORY_HPP
+#define BOOST_PERFOMANCE_LOAD_HISTORY_HPP
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <cstdlib>
+#include <boost/cstdint.hpp>
+#include <boost/scoped_array.hpp>
+#include <boost/container/vector.hpp>
+#include <boost/align/aligned_allocator.hpp>
+#include "seqlock.hpp"
+
+namespace boost { namespace perfomance { namespace detail {
+
+typedef struct {
+	float Mean;
+	float Min;
+	float Max;
+	float Median;
+	float Percentile99;
+	unsigned long SampleCount;
+} RollingLoadStruct;
+
+/*
+	   .      
+	,          -  .
+
+	   ( 1, 10  60 )   , 
+	        128 ,   
+	    O(1)    .     
+	  seqlock,       .
+*/
+class load_history {
+private:
+	enum {
+		bucket_count = 128,
+		bucket_shift = 9,	// 65536 / 128
+		max_quantized = 65535,
+		max_window_ticks = 65535	//   16-
+	};
+
+	typedef boost::alignment::aligned_allocator<boost::uint16_t, 64> row_allocator;
+
+	std::size_t series_count;
+	std::size_t row_stride;
+	std::size_t capacity;
+	std::size_t window_count;
+	boost::uint64_t tick;
+
+	/*
+		     (0..65535),    
+		      
+	*/
+	boost::container::vector<boost::uint16_t, row_allocator> samples;
+	boost::container::vector<std::size_t> window_ticks;
+	boost::container::vector<boost::uint64_t> window_sums;
+	boost::container::vector<boost::uint16_t> window_histograms;
+
+	/*
+		    ,     
+	*/
+	boost::container::vector<std::size_t> deque_offsets;
+	boost::container::vector<boost::uint64_t> min_deques;
+	boost::container::vector<boost::uint64_t> max_deques;
+	boost::container::vector<std::size_t> min_heads;
+	boost::container::vector<std::size_t> min_sizes;
+	boost::container::vector<std::size_t> max_heads;
+	boost::container::vector<std::size_t> max_sizes;
+
+	boost::scoped_array<seqlock<RollingLoadStruct> > published;
+
+	load_history(const load_history&);
+	load_history& operator=(const load_history&);
+
+	static boost::uint16_t quantize(float value) {
+		if (!(value > 0.f)) return 0;
+		if (value >= 1.f) return max_quantized;
+		return (boost::uint16_t)(value * max_quantized + 0.5f);
+	}
+
+	boost::uint16_t sample_at(boost::uint64_t sample_tick, std::size_t series) const {
+		return samples[(std::size_t)(sample_tick % capacity) * row_stride + series];
+	}
+
+	/*
+		    . keep_min = true   .
+	*/
+	void push_deque(boost::uint64_t* deque, std::size_t& head, std::size_t& size, std::size_t deque_capacity,
+		std::size_t series, boost::uint64_t window_begin, boost::uint16_t value, bool keep_min) {
+		while (size && deque[head] < window_begin) {
+			head = (head + 1) % deque_capacity;
+			size--;
+		}
+
+		while (size) {
+			boost::uint16_t back = sample_at(deque[(head + size - 1) % deque_capacity], series);
+			if (keep_min ? back < value : back > value) break;
+			size--;
+		}
+
+		deque[(head + size) % deque_capacity] = tick;
+		size++;
+	}
+
+	float percentile(const boost::uint16_t* histogram, unsigned long sample_count, float fraction) const {
+		unsigned long rank = (unsigned long)(fraction * sample_count + 0.999f);
+		unsigned long cumulative = 0;
+		if (!rank) rank = 1;
+
+		for (std::size_t i = 0; i < bucket_count; i++) {
+			cumulative += histogram[i];
+			if (cumulative >= rank) return (float)(i + 1) / bucket_count;
+		}
+
+		return 1.f;
+	}
+
+public:
+	/*
+		window_ticks_list -    ,      
+	*/
+	load_history(std::size_t core_count, const std::size_t* window_ticks_list, std::size_t windows_size)
+		: series_count(core_count + 1), capacity(1), window_count(windows_size), tick(0) {
+		/*
+			    -,       
+		*/
+		row_stride = (series_count + 31) & ~(std::size_t)31;
+
+		window_ticks.resize(window_count);
+		deque_offsets.resize(window_count);
+
+		std::size_t deque_total = 0;
+		for (std::size_t w = 0; w < window_count; w++) {
+			window_ticks[w] = window_ticks_list[w] ? window_ticks_list[w] : 1;
+			if (window_ticks[w] > max_window_ticks) window_ticks[w] = max_window_ticks;
+			if (window_ticks[w] > capacity) capacity = window_ticks[w];
+
+			deque_offsets[w] = deque_total;
+			deque_total += window_ticks[w] * series_count;
+		}
+
+		samples.resize(capacity * row_stride);
+		window_sums.resize(window_count * series_count);
+		window_histograms.resize(window_count * series_count * bucket_count);
+		min_deques.resize(deque_total);
+		max_deques.resize(deque_total);
+		min_heads.resize(window_count * series_count);
+		min_sizes.resize(window_count * series_count);
+		max_heads.resize(window_count * series_count);
+		max_sizes.resize(window_count * series_count);
+		published.reset(new seqlock<RollingLoadStruct>[window_count * series_count]);
+	}
+
+	std::size_t get_window_count() const {
+		return window_count;
+	}
+
+	std::size_t get_core_count() const {
+		return series_count - 1;
+	}
+
+	/*
+		    - (  )
+	*/
+	void push(const float* core_load) {
+		const std::size_t core_count = series_count - 1;
+		boost::uint16_t* row = &samples[(std::size_t)(tick % capacity) * row_stride];
+		float base_load = 0.f;
+
+		/*
+			       ,  
+			    ,     
+		*/
+		for (std::size_t w = 0; w < window_count; w++) {
+			if (tick < window_ticks[w]) continue;
+
+			const boost::uint16_t* old_row = &samples[(std::size_t)((tick - window_ticks[w]) % capacity) * row_stride];
+			for (std::size_t s = 0; s < series_count; s++) {
+				std::size_t index = w * series_count + s;
+				window_sums[index] -= old_row[s];
+				window_histograms[index * bucket_count + (old_row[s] >> bucket_shift)]--;
+			}
+		}
+
+		for (std::size_t s = 0; s < core_count; s++) {
+			row[s] = quantize(core_load[s]);
+			base_load += core_load[s];
+		}
+
+		row[core_count] = quantize(core_count ? base_load / core_count : 0.f);
+
+		for (std::size_t w = 0; w < window_count; w++) {
+			const std::size_t ticks = window_ticks[w];
+			const boost::uint64_t window_begin = tick + 1 >= ticks ? tick + 1 - ticks : 0;
+			const unsigned long sample_count = (unsigned long)(tick + 1 < ticks ? tick + 1 : ticks);
+
+			for (std::size_t s = 0; s < series_count; s++) {
+				std::size_t index = w * series_count + s;
+				boost::uint64_t* min_deque = &min_deques[deque_offsets[w] + s * ticks];
+				boost::uint64_t* max_deque = &max_deques[deque_offsets[w] + s * ticks];
+				const boost::uint16_t* histogram = &window_histograms[index * bucket_count];
+
+				window_sums[index] += row[s];
+				window_histograms[index * bucket_count + (row[s] >> bucket_shift)]++;
+				push_deque(min_deque, min_heads[index], min_sizes[index], ticks, s, window_begin, row[s], true);
+				push_deque(max_deque, max_heads[index], max_sizes[index], ticks, s, window_begin, row[s], false);
+
+				RollingLoadStruct stats;
+				stats.SampleCount = sample_count;
+				stats.Mean = (float)((double)window_sums[index] / sample_count / max_quantized);
+				stats.Min = (float)sample_at(min_deque[min_heads[index]], s) / max_quantized;
+				stats.Max = (float)sample_at(max_deque[max_heads[index]], s) / max_quantized;
+
+				/*
+					     ,    1%,
+					      
+				*/
+				stats.Median = percentile(histogram, sample_count, 0.5f);
+				stats.Percentile99 = percentile(histogram, sample_count, 0.99f);
+				if (stats.Median > stats.Max) stats.Median = stats.Max;
+				if (stats.Median < stats.Min) stats.Median = stats.Min;
+				if (stats.Percentile99 > stats.Max) stats.Percentile99 = stats.Max;
+				if (stats.Percentile99 < stats.Min) stats.Percentile99 = stats.Min;
+
+				published[index].store(&stats);
+			}
+		}
+
+		tick++;
+	}
+
+	void push(const boost::container::vector<float>& core_load) {
+		if (core_load.size() == series_count - 1) push(core_load.data());
+	}
+
+	/*
+		       .  false,    .
+	*/
+	bool get_rolling_load(std::size_t window_index, std::size_t core_index, RollingLoadStruct& stats) const {
+		if (window_index >= window_count || core_index >= series_count - 1) return false;
+		return published[window_index * series_count + core_index].load(&stats);
+	}
+
+	/*
+		    
+	*/
+	bool get_rolling_load(std::size_t window_index, RollingLoadStruct& stats) const {
+		if (window_index >= window_count) return false;
+		return published[window_index * series_count + series_count - 1].load(&stats);
+	}
+};
+
+}}}
+#endif
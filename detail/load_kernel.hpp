@@ -0,0 +1,249 @@
+#ifndef BOOST_PERFOMANCE_LOAD_KERNEL_HPP
+#define BOOST_PERFOMANCE_LOAD_KERNEL_HPP
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <cstdlib>
+#include <boost/config.hpp>
+#include <boost/cstdint.hpp>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define BOOST_PERFOMANCE_HAS_LOAD_KERNELS
+#define BOOST_PERFOMANCE_TARGET(name) __attribute__((target(name)))
+#elif defined(_MSC_VER) && defined(_M_X64)
+#include <immintrin.h>
+#include <intrin.h>
+#define BOOST_PERFOMANCE_HAS_LOAD_KERNELS
+#define BOOST_PERFOMANCE_TARGET(name)
+#endif
+
+namespace boost { namespace perfomance { namespace detail {
+
+/*
+	       .     
+	 64-  (       ),  
+	      .
+
+	   load = 1 - d(idle) / d(total),    total 
+	 ,      [0, 1] ( Linux
+	iowait  ,       ).
+	       .  
+	 .
+*/
+typedef struct {
+	const boost::uint64_t* IdleTime;
+	const boost::uint64_t* TotalTime;
+	boost::uint64_t* PrevIdleTime;
+	boost::uint64_t* PrevTotalTime;
+} CoreLoadStateStruct;
+
+typedef float (*core_load_kernel)(const CoreLoadStateStruct& state, float* load, std::size_t count);
+
+namespace load_kernels {
+
+inline float finish_load(double delta_idle, double delta_total) {
+	if (delta_total <= 0.0) return 0.f;
+
+	double ret_value = 1.0 - delta_idle / delta_total;
+	return (float)(ret_value < 0.0 ? 0.0 : (ret_value > 1.0 ? 1.0 : ret_value));
+}
+
+/*
+	  ,       
+*/
+inline void scalar_step(const CoreLoadStateStruct& state, float* load, std::size_t i, double& sum_idle, double& sum_total) {
+	boost::uint64_t delta_total = state.TotalTime[i] - state.PrevTotalTime[i];
+	boost::uint64_t delta_idle = state.IdleTime[i] - state.PrevIdleTime[i];
+
+	/*
+		   ,    
+	*/
+	if (delta_idle > delta_total) delta_idle = delta_total;
+
+	load[i] = finish_load((double)delta_idle, (double)delta_total);
+	sum_idle += (double)delta_idle;
+	sum_total += (double)delta_total;
+
+	state.PrevIdleTime[i] = state.IdleTime[i];
+	state.PrevTotalTime[i] = state.TotalTime[i];
+}
+
+inline float scalar(const CoreLoadStateStruct& state, float* load, std::size_t count) {
+	double sum_idle = 0.0;
+	double sum_total = 0.0;
+
+	for (std::size_t i = 0; i < count; i++) {
+		scalar_step(state, load, i, sum_idle, sum_total);
+	}
+
+	return finish_load(sum_idle, sum_total);
+}
+
+#ifdef BOOST_PERFOMANCE_HAS_LOAD_KERNELS
+/*
+	 AVX2   uint64 -> double,     :
+	  2^52,    2^52,   2^52  
+	.         2^52,  
+	 ( )  .
+*/
+BOOST_PERFOMANCE_TARGET("avx2")
+inline __m256d avx2_to_double(__m256i value) {
+	const __m256i limit = _mm256_set1_epi64x((1ll << 52) - 1);
+	const __m256d magic = _mm256_set1_pd(4503599627370496.0);
+
+	__m256i too_large = _mm256_cmpgt_epi64(_mm256_xor_si256(value, _mm256_set1_epi64x((long long)0x8000000000000000ull)),
+		_mm256_xor_si256(limit, _mm256_set1_epi64x((long long)0x8000000000000000ull)));
+	value = _mm256_blendv_epi8(value, limit, too_large);
+	return _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(value, _mm256_castpd_si256(magic))), magic);
+}
+
+BOOST_PERFOMANCE_TARGET("avx2")
+inline float avx2(const CoreLoadStateStruct& state, float* load, std::size_t count) {
+	const __m256d zero = _mm256_setzero_pd();
+	const __m256d one = _mm256_set1_pd(1.0);
+	__m256d sum_idle = zero;
+	__m256d sum_total = zero;
+	std::size_t i = 0;
+
+	for (; i + 4 <= count; i += 4) {
+		__m256i idle = _mm256_loadu_si256((const __m256i*)(state.IdleTime + i));
+		__m256i total = _mm256_loadu_si256((const __m256i*)(state.TotalTime + i));
+		__m256i prev_idle = _mm256_loadu_si256((const __m256i*)(state.PrevIdleTime + i));
+		__m256i prev_total = _mm256_loadu_si256((const __m256i*)(state.PrevTotalTime + i));
+
+		_mm256_storeu_si256((__m256i*)(state.PrevIdleTime + i), idle);
+		_mm256_storeu_si256((__m256i*)(state.PrevTotalTime + i), total);
+
+		__m256d delta_total = avx2_to_double(_mm256_sub_epi64(total, prev_total));
+		__m256d delta_idle = _mm256_min_pd(avx2_to_double(_mm256_sub_epi64(idle, prev_idle)), delta_total);
+
+		sum_idle = _mm256_add_pd(sum_idle, delta_idle);
+		sum_total = _mm256_add_pd(sum_total, delta_total);
+
+		/*
+			    NaN,      
+		*/
+		__m256d has_delta = _mm256_cmp_pd(delta_total, zero, _CMP_GT_OQ);
+		__m256d core_load = _mm256_sub_pd(one, _mm256_div_pd(delta_idle, delta_total));
+		core_load = _mm256_and_pd(_mm256_max_pd(_mm256_min_pd(core_load, one), zero), has_delta);
+		_mm_storeu_ps(load + i, _mm256_cvtpd_ps(core_load));
+	}
+
+	double idle_lanes[4];
+	double total_lanes[4];
+	_mm256_storeu_pd(idle_lanes, sum_idle);
+	_mm256_storeu_pd(total_lanes, sum_total);
+
+	double tail_idle = idle_lanes[0] + idle_lanes[1] + idle_lanes[2] + idle_lanes[3];
+	double tail_total = total_lanes[0] + total_lanes[1] + total_lanes[2] + total_lanes[3];
+	for (; i < count; i++) {
+		scalar_step(state, load, i, tail_idle, tail_total);
+	}
+
+	return finish_load(tail_idle, tail_total);
+}
+
+/*
+	GCC 12       
+	 AVX-512       target
+*/
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+BOOST_PERFOMANCE_TARGET("avx512f,avx512dq")
+inline float avx512(const CoreLoadStateStruct& state, float* load, std::size_t count) {
+	const __m512d zero = _mm512_setzero_pd();
+	const __m512d one = _mm512_set1_pd(1.0);
+	__m512d sum_idle = zero;
+	__m512d sum_total = zero;
+	std::size_t i = 0;
+
+	for (; i + 8 <= count; i += 8) {
+		__m512i idle = _mm512_loadu_si512((const void*)(state.IdleTime + i));
+		__m512i total = _mm512_loadu_si512((const void*)(state.TotalTime + i));
+		__m512i prev_idle = _mm512_loadu_si512((const void*)(state.PrevIdleTime + i));
+		__m512i prev_total = _mm512_loadu_si512((const void*)(state.PrevTotalTime + i));
+
+		_mm512_storeu_si512((void*)(state.PrevIdleTime + i), idle);
+		_mm512_storeu_si512((void*)(state.PrevTotalTime + i), total);
+
+		__m512i delta_total_int = _mm512_sub_epi64(total, prev_total);
+		__m512i delta_idle_int = _mm512_min_epu64(_mm512_sub_epi64(idle, prev_idle), delta_total_int);
+		__m512d delta_total = _mm512_cvtepu64_pd(delta_total_int);
+		__m512d delta_idle = _mm512_cvtepu64_pd(delta_idle_int);
+
+		sum_idle = _mm512_add_pd(sum_idle, delta_idle);
+		sum_total = _mm512_add_pd(sum_total, delta_total);
+
+		__mmask8 has_delta = _mm512_cmp_pd_mask(delta_total, zero, _CMP_GT_OQ);
+		__m512d core_load = _mm512_maskz_sub_pd(has_delta, one, _mm512_maskz_div_pd(has_delta, delta_idle, delta_total));
+		core_load = _mm512_max_pd(_mm512_min_pd(core_load, one), zero);
+		_mm256_storeu_ps(load + i, _mm512_cvtpd_ps(core_load));
+	}
+
+	double tail_idle = _mm512_reduce_add_pd(sum_idle);
+	double tail_total = _mm512_reduce_add_pd(sum_total);
+	for (; i < count; i++) {
+		scalar_step(state, load, i, tail_idle, tail_total);
+	}
+
+	return finish_load(tail_idle, tail_total);
+}
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+/*
+	 ,      (XCR0)
+*/
+inline bool cpu_supports(bool avx512) {
+#if defined(__GNUC__)
+	__builtin_cpu_init();
+	if (avx512) return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq");
+	return __builtin_cpu_supports("avx2") != 0;
+#else
+	int registers[4] = {};
+	__cpuid(registers, 1);
+	if (!(registers[2] & (1 << 27)) || !(registers[2] & (1 << 28))) return false;
+
+	unsigned long long xcr0 = _xgetbv(0);
+	unsigned long long required = avx512 ? 0xe6ull : 0x6ull;
+	if ((xcr0 & required) != required) return false;
+
+	__cpuidex(registers, 7, 0);
+	if (avx512) return (registers[1] & (1 << 16)) && (registers[1] & (1 << 17));
+	return (registers[1] & (1 << 5)) != 0;
+#endif
+}
+#endif
+
+}
+
+/*
+	       
+*/
+inline core_load_kernel select_core_load_kernel() {
+#ifdef BOOST_PERFOMANCE_HAS_LOAD_KERNELS
+	if (load_kernels::cpu_supports(true)) return &load_kernels::avx512;
+	if (load_kernels::cpu_supports(false)) return &load_kernels::avx2;
+#endif
+	return &load_kernels::scalar;
+}
+
+/*
+	 load[0..count)    
+*/
+inline float calculate_core_load(const CoreLoadStateStruct& state, float* load, std::size_t count) {
+	static const core_load_kernel kernel = select_core_load_kernel();
+	return kernel(state, load, count);
+}
+
+}}}
+
+#undef BOOST_PERFOMANCE_TARGET
+#endif
@@ -0,0 +1,193 @@
+#ifndef BOOST_PERFOMANCE_OPEN_HASH_MAP_HPP
+#define BOOST_PERFOMANCE_OPEN_HASH_MAP_HPP
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <cstdlib>
+#include <boost/cstdint.hpp>
+#include <boost/container/vector.hpp>
+#include <boost/move/utility_core.hpp>
+
+namespace boost { namespace perfomance { namespace detail {
+
+/*
+	-         
+	(inode, PID, cookie ). ,       
+	,     ,     
+	,         .
+*/
+template <class Value>
+class open_hash_map {
+private:
+	boost::container::vector<boost::uint64_t> keys;
+	boost::container::vector<Value> values;
+	boost::container::vector<unsigned char> occupied;
+	std::size_t mask;
+	std::size_t element_count;
+
+	static std::size_t hash(boost::uint64_t key) {
+		key ^= key >> 33;
+		key *= 0xff51afd7ed558ccdull;
+		key ^= key >> 33;
+		key *= 0xc4ceb9fe1a85ec53ull;
+		key ^= key >> 33;
+		return (std::size_t)key;
+	}
+
+	static std::size_t round_capacity(std::size_t capacity) {
+		std::size_t ret_value = 16;
+		while (ret_value < capacity) ret_value <<= 1;
+		return ret_value;
+	}
+
+	std::size_t find_slot(boost::uint64_t key) const {
+		std::size_t slot = hash(key) & mask;
+		while (occupied[slot] && keys[slot] != key) {
+			slot = (slot + 1) & mask;
+		}
+
+		return slot;
+	}
+
+	void rehash(std::size_t capacity) {
+		boost::container::vector<boost::uint64_t> old_keys(boost::move(keys));
+		boost::container::vector<Value> old_values(boost::move(values));
+		boost::container::vector<unsigned char> old_occupied(boost::move(occupied));
+
+		keys.clear();
+		values.clear();
+		occupied.clear();
+		keys.resize(capacity);
+		values.resize(capacity);
+		occupied.resize(capacity);
+		mask = capacity - 1;
+
+		for (std::size_t i = 0; i < old_occupied.size(); i++) {
+			if (!old_occupied[i]) continue;
+
+			std::size_t slot = find_slot(old_keys[i]);
+			occupied[slot] = 1;
+			keys[slot] = old_keys[i];
+			values[slot] = boost::move(old_values[i]);
+		}
+	}
+
+public:
+	explicit open_hash_map(std::size_t initial_capacity = 16) : mask(0), element_count(0) {
+		rehash(round_capacity(initial_capacity * 2));
+	}
+
+	std::size_t size() const {
+		return element_count;
+	}
+
+	/*
+		  ,   count    
+	*/
+	void reserve(std::size_t count) {
+		if (count * 2 > occupied.size()) rehash(round_capacity(count * 2));
+	}
+
+	void clear() {
+		for (std::size_t i = 0; i < occupied.size(); i++) {
+			occupied[i] = 0;
+		}
+
+		element_count = 0;
+	}
+
+	Value* find(boost::uint64_t key) {
+		std::size_t slot = find_slot(key);
+		return occupied[slot] ? &values[slot] : NULL;
+	}
+
+	const Value* find(boost::uint64_t key) const {
+		std::size_t slot = find_slot(key);
+		return occupied[slot] ? &values[slot] : NULL;
+	}
+
+	/*
+		   ,    . inserted ,
+		      (      Value()).
+	*/
+	Value& insert(boost::uint64_t key, bool& inserted) {
+		if ((element_count + 1) * 2 > occupied.size()) rehash(occupied.size() * 2);
+
+		std::size_t slot = find_slot(key);
+		inserted = !occupied[slot];
+
+		if (inserted) {
+			occupied[slot] = 1;
+			keys[slot] = key;
+			values[slot] = Value();
+			element_count++;
+		}
+
+		return values[slot];
+	}
+
+	Value& operator[](boost::uint64_t key) {
+		bool inserted = false;
+		return insert(key, inserted);
+	}
+
+	/*
+		     ,  
+	*/
+	bool erase(boost::uint64_t key) {
+		std::size_t slot = find_slot(key);
+		if (!occupied[slot]) return false;
+
+		std::size_t next = (slot + 1) & mask;
+		while (occupied[next]) {
+			std::size_t home = hash(keys[next]) & mask;
+
+			/*
+				     ,    
+				        
+			*/
+			if (((next - home) & mask) >= ((next - slot) & mask)) {
+				keys[slot] = keys[next];
+				values[slot] = boost::move(values[next]);
+				slot = next;
+			}
+
+			next = (next + 1) & mask;
+		}
+
+		occupied[slot] = 0;
+		element_count--;
+		return true;
+	}
+
+	/*
+		  , functor(key, value)
+	*/
+	template <class Functor>
+	void for_each(Functor& functor) {
+		for (std::size_t i = 0; i < occupied.size(); i++) {
+			if (occupied[i]) functor(keys[i], values[i]);
+		}
+	}
+
+	/*
+		  ,   predicate(key, value)  true. 
+		 ,     .
+	*/
+	template <class Predicate>
+	void erase_if(Predicate& predicate) {
+		for (std::size_t i = 0; i < occupied.size(); i++) {
+			if (occupied[i] && predicate(keys[i], values[i])) {
+				occupied[i] = 0;
+				element_count--;
+			}
+		}
+
+		rehash(occupied.size());
+	}
+};
+
+}}}
+#endif
@@ -0,0 +1,663 @@
+#ifndef BOOST_PERFOMANCE_OPENMETRICS_EXPORTER_HPP
+#define BOOST_PERFOMANCE_OPENMETRICS_EXPORTER_HPP
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <cstdlib>
+#include <cstring>
+#include <charconv>
+#include <boost/cstdint.hpp>
+#include <boost/array.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/container/vector.hpp>
+#include <boost/scoped_ptr.hpp>
+#include "platform.hpp"
+#include "scope_timer.hpp"
+
+#ifdef __linux__
+#include "linux/network_counter.hpp"
+#include "linux/interface_counter.hpp"
+#include "linux/cgroup_counter.hpp"
+#endif
+
+namespace boost { namespace perfomance { namespace detail {
+
+/*
+	   OpenMetrics,        .  
+	     ,     
+	   .    std::to_chars.
+*/
+class openmetrics_buffer {
+private:
+	boost::container::vector<char> buffer;
+	std::size_t data_size;
+	bool labels_open;
+
+	void reserve_more(std::size_t size) {
+		if (data_size + size <= buffer.size()) return;
+
+		std::size_t new_size = buffer.size() * 2;
+		if (new_size < data_size + size) new_size = data_size + size;
+		buffer.resize(new_size);
+	}
+
+	void append(const char* data, std::size_t size) {
+		reserve_more(size);
+		std::memcpy(&buffer[data_size], data, size);
+		data_size += size;
+	}
+
+	void append(const char* string) {
+		append(string, std::strlen(string));
+	}
+
+	void append(char symbol) {
+		reserve_more(1);
+		buffer[data_size++] = symbol;
+	}
+
+	void append_number(unsigned long long value) {
+		reserve_more(24);
+		std::to_chars_result result = std::to_chars(&buffer[data_size], &buffer[data_size] + 24, value);
+		data_size = (std::size_t)(result.ptr - &buffer[0]);
+	}
+
+	void append_number(double value) {
+		if (value != value) return append("NaN");
+		if (value > 1.7976931348623157e308) return append("+Inf");
+		if (value < -1.7976931348623157e308) return append("-Inf");
+
+		reserve_more(32);
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+		std::to_chars_result result = std::to_chars(&buffer[data_size], &buffer[data_size] + 32, value);
+		data_size = (std::size_t)(result.ptr - &buffer[0]);
+#else
+		int written = std::snprintf(&buffer[data_size], 32, "%.17g", value);
+		if (written > 0) data_size += (std::size_t)written;
+#endif
+	}
+
+	/*
+		   ,   \, "   
+	*/
+	void append_label_value(const char* value) {
+		append('"');
+		for (; *value; value++) {
+			if (*value == '\\' || *value == '"') {
+				append('\\');
+				append(*value);
+			} else if (*value == '\n') {
+				append("\\n", 2);
+			} else {
+				append(*value);
+			}
+		}
+
+		append('"');
+	}
+
+	void append_label_separator(const char* key) {
+		append(labels_open ? ',' : '{');
+		labels_open = true;
+		append(key);
+		append('=');
+	}
+
+	void finish_sample() {
+		if (labels_open) append('}');
+		labels_open = false;
+		append(' ');
+	}
+
+public:
+	explicit openmetrics_buffer(std::size_t initial_size = 65536) : data_size(0), labels_open(false) {
+		buffer.resize(initial_size);
+	}
+
+	void clear() {
+		data_size = 0;
+		labels_open = false;
+	}
+
+	const char* data() const {
+		return buffer.data();
+	}
+
+	std::size_t size() const {
+		return data_size;
+	}
+
+	/*
+		  : type - gauge, counter  ..
+	*/
+	void family(const char* name, const char* type, const char* help) {
+		append("# TYPE ");
+		append(name);
+		append(' ');
+		append(type);
+		append("\n# HELP ");
+		append(name);
+		append(' ');
+		append(help);
+		append('\n');
+	}
+
+	/*
+		  . suffix  ,    
+		name_total
+	*/
+	void sample(const char* name, const char* suffix = NULL) {
+		append(name);
+		if (suffix) append(suffix);
+	}
+
+	void label(const char* key, const char* value) {
+		append_label_separator(key);
+		append_label_value(value);
+	}
+
+	void label(const char* key, unsigned long long value) {
+		append_label_separator(key);
+		append('"');
+		append_number(value);
+		append('"');
+	}
+
+	void value(double sample_value) {
+		finish_sample();
+		append_number(sample_value);
+		append('\n');
+	}
+
+	void value(unsigned long long sample_value) {
+		finish_sample();
+		append_number(sample_value);
+		append('\n');
+	}
+
+	void finish() {
+		append("# EOF\n");
+	}
+};
+
+/*
+	     OpenMetrics  HTTP (GET /metrics)  
+	.   io_context  : exporter   
+	,  run()  .     .
+
+	  keep-alive     connection_count , 
+	    exporter .     , 
+	,    ,  .    ,
+	     acceptor     , 
+	    .    
+	 strand,  io_context      .
+*/
+class openmetrics_exporter {
+private:
+	enum {
+		request_buffer_size = 4096,
+		idle_timeout_seconds = 30,
+		connection_count = 4
+	};
+
+	typedef boost::asio::strand<boost::asio::io_context::executor_type> strand_type;
+
+	/*
+		  :  ,      
+		,       acceptor
+	*/
+	class connection {
+	private:
+		openmetrics_exporter& exporter;
+		boost::asio::steady_timer idle_timer;
+
+		/*
+			   . ,    , 
+			 cancel  expires_after   ,     
+			 ,       ,   ec.
+		*/
+		unsigned long idle_generation;
+
+		boost::array<char, request_buffer_size> request_buffer;
+		std::size_t request_size;
+		boost::array<char, 256> header_buffer;
+		std::size_t header_size;
+		bool close_after_write;
+		openmetrics_buffer body;
+
+		connection(const connection&);
+		connection& operator=(const connection&);
+
+		void build_header(const char* status, const char* content_type, std::size_t content_length) {
+			char* cur = header_buffer.data();
+			char* end = cur + header_buffer.size();
+
+			std::size_t status_size = std::strlen(status);
+			std::memcpy(cur, "HTTP/1.1 ", 9);
+			std::memcpy(cur + 9, status, status_size);
+			cur += 9 + status_size;
+
+			const char content_type_name[] = "\r\nContent-Type: ";
+			std::memcpy(cur, content_type_name, sizeof(content_type_name) - 1);
+			cur += sizeof(content_type_name) - 1;
+
+			std::size_t content_type_size = std::strlen(content_type);
+			std::memcpy(cur, content_type, content_type_size);
+			cur += content_type_size;
+
+			const char content_length_name[] = "\r\nContent-Length: ";
+			std::memcpy(cur, content_length_name, sizeof(content_length_name) - 1);
+			cur += sizeof(content_length_name) - 1;
+			cur = std::to_chars(cur, end, (unsigned long long)content_length).ptr;
+
+			const char* connection_header = close_after_write ? "\r\nConnection: close\r\n\r\n" : "\r\n\r\n";
+			std::size_t connection_size = std::strlen(connection_header);
+			std::memcpy(cur, connection_header, connection_size);
+			header_size = (std::size_t)(cur + connection_size - header_buffer.data());
+		}
+
+		void start_read() {
+			unsigned long generation = ++idle_generation;
+			idle_timer.expires_after(std::chrono::seconds(idle_timeout_seconds));
+			idle_timer.async_wait([this, generation](const boost::system::error_code&) {
+				if (generation != idle_generation) return;
+
+				boost::system::error_code ignored;
+				socket.close(ignored);
+			});
+
+			socket.async_read_some(boost::asio::buffer(request_buffer.data() + request_size, request_buffer.size() - request_size),
+				[this](const boost::system::error_code& ec, std::size_t read_size) {
+					if (ec) return close();
+
+					request_size += read_size;
+					handle_request();
+				});
+		}
+
+		/*
+			      Connection,   GET  
+		*/
+		void handle_request() {
+			const char* begin = request_buffer.data();
+			const char* end = begin + request_size;
+			const char* header_end = NULL;
+
+			for (const char* cur = begin; cur + 4 <= end; cur++) {
+				if (cur[0] == '\r' && cur[1] == '\n' && cur[2] == '\r' && cur[3] == '\n') {
+					header_end = cur + 4;
+					break;
+				}
+			}
+
+			if (!header_end) {
+				if (request_size == request_buffer.size()) return close();
+				return start_read();
+			}
+
+			close_after_write = false;
+			for (const char* cur = begin; cur + 17 <= header_end; cur++) {
+				if (equals_ignore_case(cur, "connection: close", 17)) {
+					close_after_write = true;
+					break;
+				}
+			}
+
+			/*
+				  -    (pipelining)
+			*/
+			std::size_t consumed = (std::size_t)(header_end - begin);
+			bool is_metrics = request_size >= 13 && (!std::memcmp(begin, "GET /metrics ", 13) || !std::memcmp(begin, "GET /metrics?", 13));
+			bool is_get = request_size >= 4 && !std::memcmp(begin, "GET ", 4);
+
+			std::memmove(request_buffer.data(), header_end, request_size - consumed);
+			request_size -= consumed;
+
+			if (is_metrics) {
+				exporter.build_metrics(body);
+				build_header("200 OK", "application/openmetrics-text; version=1.0.0; charset=utf-8", body.size());
+				write_response(body.size());
+			} else {
+				build_header(is_get ? "404 Not Found" : "405 Method Not Allowed", "text/plain", 0);
+				write_response(0);
+			}
+		}
+
+		void write_response(std::size_t body_size) {
+			boost::array<boost::asio::const_buffer, 2> buffers = { {
+				boost::asio::buffer(header_buffer.data(), header_size),
+				boost::asio::buffer(body.data(), body_size)
+			} };
+
+			boost::asio::async_write(socket, buffers, [this](const boost::system::error_code& ec, std::size_t) {
+				if (ec || close_after_write) return close();
+				handle_request();
+			});
+		}
+
+		void close() {
+			boost::system::error_code ec;
+			idle_generation++;
+			idle_timer.cancel();
+			socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+			socket.close(ec);
+			is_busy = false;
+			exporter.start_accept();
+		}
+
+	public:
+		boost::asio::ip::tcp::socket socket;
+
+		/*
+			  acceptor  
+		*/
+		bool is_busy;
+
+		connection(openmetrics_exporter& owner, const strand_type& strand)
+			: exporter(owner), idle_timer(strand), idle_generation(0), request_size(0), header_size(0),
+			close_after_write(false), socket(strand), is_busy(false) {}
+
+		void start() {
+			request_size = 0;
+			start_read();
+		}
+
+		/*
+			         
+		*/
+		void stop() {
+			boost::system::error_code ec;
+			idle_generation++;
+			idle_timer.cancel();
+			socket.close(ec);
+		}
+	};
+
+	strand_type strand;
+	boost::asio::ip::tcp::acceptor acceptor;
+	boost::scoped_ptr<connection> connections[connection_count];
+	bool is_accepting;
+	bool is_stopped;
+	openmetrics_buffer render_body;
+
+	platform::cpu_counter cpu;
+	platform::memory_counter memory;
+	boost::container::vector<float> core_load;
+	boost::container::vector<ScopeStatisticsStruct> scope_statistics;
+
+#ifdef __linux__
+	linux_::netword_counter network;
+	linux_::interface_counter interfaces;
+	linux_::cgroup_counter cgroup;
+	boost::container::vector<linux_::InterfaceStatisticsStruct> interface_statistics;
+#endif
+
+	openmetrics_exporter(const openmetrics_exporter&);
+	openmetrics_exporter& operator=(const openmetrics_exporter&);
+
+	void write_cpu_metrics(openmetrics_buffer& body) {
+		float base_load = 0.f;
+		if (!cpu.get_load_per_core(core_load, base_load)) return;
+
+		body.family("boost_perfomance_cpu_load", "gauge", "CPU load since the previous scrape, 0..1");
+		body.sample("boost_perfomance_cpu_load");
+		body.value((double)base_load);
+
+		body.family("boost_perfomance_cpu_core_load", "gauge", "Per-core CPU load since the previous scrape, 0..1");
+		for (std::size_t i = 0; i < core_load.size(); i++) {
+			body.sample("boost_perfomance_cpu_core_load");
+			body.label("core", (unsigned long long)i);
+			body.value((double)core_load[i]);
+		}
+	}
+
+	void write_memory_metrics(openmetrics_buffer& body) {
+		unsigned long long value = 0;
+		unsigned long long committed = 0;
+
+		/*
+			   -    /proc/meminfo
+		*/
+		body.family("boost_perfomance_memory_bytes", "gauge", "System and process memory usage in bytes");
+		if (memory.get_system_memory_load(value, committed)) {
+			body.sample("boost_perfomance_memory_bytes");
+			body.label("kind", "system_swap");
+			body.value(value);
+
+			body.sample("boost_perfomance_memory_bytes");
+			body.label("kind", "system_committed");
+			body.value(committed);
+		}
+
+		if (memory.get_process_swap_load(value)) {
+			body.sample("boost_perfomance_memory_bytes");
+			body.label("kind", "process_swap");
+			body.value(value);
+		}
+
+		if (memory.get_process_vmemory_load(value)) {
+			body.sample("boost_perfomance_memory_bytes");
+			body.label("kind", "process_resident");
+			body.value(value);
+		}
+	}
+
+	void write_scope_metrics(openmetrics_buffer& body) {
+		scope_registry& registry = scope_registry::instance();
+		registry.collect();
+		registry.get_statistics(scope_statistics);
+		if (scope_statistics.empty()) return;
+
+		body.family("boost_perfomance_scope_calls", "counter", "Number of completed BOOST_PERFOMANCE_SCOPE measurements");
+		for (std::size_t i = 0; i < scope_statistics.size(); i++) {
+			body.sample("boost_perfomance_scope_calls", "_total");
+			body.label("scope", scope_statistics[i].Name);
+			body.value(scope_statistics[i].Count);
+		}
+
+		body.family("boost_perfomance_scope_seconds", "counter", "Total time spent in BOOST_PERFOMANCE_SCOPE measurements");
+		for (std::size_t i = 0; i < scope_statistics.size(); i++) {
+			body.sample("boost_perfomance_scope_seconds", "_total");
+			body.label("scope", scope_statistics[i].Name);
+			body.value(scope_statistics[i].TotalNanoseconds * 1e-9);
+		}
+
+		body.family("boost_perfomance_scope_dropped", "counter", "Measurements lost because a thread buffer was full");
+		body.sample("boost_perfomance_scope_dropped", "_total");
+		body.value(registry.get_dropped_records());
+	}
+
+#ifdef __linux__
+	void write_network_metrics(openmetrics_buffer& body) {
+		linux_::NetworkGlobalStatus status;
+		if (!network.get_global_network_info(status)) return;
+
+		body.family("boost_perfomance_tcp_connections", "gauge", "Established TCP connections");
+		body.sample("boost_perfomance_tcp_connections");
+		body.value((unsigned long long)status.CountOfTCPConnections);
+
+		body.family("boost_perfomance_network_events_per_second", "gauge", "TCP/UDP event rates since the previous scrape");
+		const char* const kinds[] = { "tcp_retransmits", "tcp_resets", "tcp_listen_overflows", "udp_receive_buffer_errors", "tcp_active_opens", "tcp_passive_opens" };
+		const double rates[] = { status.RetransmitsPerSecond, status.ResetsPerSecond, status.ListenOverflowsPerSecond,
+			status.UdpReceiveBufferErrorsPerSecond, status.ActiveOpensPerSecond, status.PassiveOpensPerSecond };
+
+		for (std::size_t i = 0; i < sizeof(rates) / sizeof(rates[0]); i++) {
+			body.sample("boost_perfomance_network_events_per_second");
+			body.label("kind", kinds[i]);
+			body.value(rates[i]);
+		}
+	}
+
+	void write_interface_metrics(openmetrics_buffer& body) {
+		if (!interfaces.get_interface_statistics(interface_statistics) || interface_statistics.empty()) return;
+
+		body.family("boost_perfomance_interface_bytes_per_second", "gauge", "Per-interface throughput since the previous scrape");
+		for (std::size_t i = 0; i < interface_statistics.size(); i++) {
+			body.sample("boost_perfomance_interface_bytes_per_second");
+			body.label("interface", interface_statistics[i].Name);
+			body.label("direction", "receive");
+			body.value(interface_statistics[i].ReceiveBytesPerSecond);
+
+			body.sample("boost_perfomance_interface_bytes_per_second");
+			body.label("interface", interface_statistics[i].Name);
+			body.label("direction", "transmit");
+			body.value(interface_statistics[i].TransmitBytesPerSecond);
+		}
+
+		body.family("boost_perfomance_interface_drops_per_second", "gauge", "Per-interface dropped packets since the previous scrape");
+		for (std::size_t i = 0; i < interface_statistics.size(); i++) {
+			body.sample("boost_perfomance_interface_drops_per_second");
+			body.label("interface", interface_statistics[i].Name);
+			body.label("direction", "receive");
+			body.value(interface_statistics[i].ReceiveDropsPerSecond);
+
+			body.sample("boost_perfomance_interface_drops_per_second");
+			body.label("interface", interface_statistics[i].Name);
+			body.label("direction", "transmit");
+			body.value(interface_statistics[i].TransmitDropsPerSecond);
+		}
+	}
+
+	void write_cgroup_metrics(openmetrics_buffer& body) {
+		if (!cgroup.is_available()) return;
+
+		linux_::CgroupCpuStruct cpu_statistics;
+		if (cgroup.get_cpu_statistics(cpu_statistics)) {
+			body.family("boost_perfomance_cgroup_cpu_quota", "gauge", "CPUs available to the cgroup");
+			body.sample("boost_perfomance_cgroup_cpu_quota");
+			body.value(cpu_statistics.CpuQuota);
+
+			body.family("boost_perfomance_cgroup_cpu_load", "gauge", "cgroup CPU usage relative to its quota");
+			body.sample("boost_perfomance_cgroup_cpu_load");
+			body.value((double)cpu_statistics.CpuLoad);
+
+			body.family("boost_perfomance_cgroup_throttled_ratio", "gauge", "Share of CFS periods in which the cgroup was throttled");
+			body.sample("boost_perfomance_cgroup_throttled_ratio");
+			body.value((double)cpu_statistics.ThrottledFraction);
+		}
+
+		linux_::CgroupMemoryStruct memory_statistics;
+		if (cgroup.get_memory_statistics(memory_statistics)) {
+			body.family("boost_perfomance_cgroup_memory_bytes", "gauge", "cgroup memory usage and limit");
+			body.sample("boost_perfomance_cgroup_memory_bytes");
+			body.label("kind", "current");
+			body.value(memory_statistics.MemoryCurrent);
+
+			body.sample("boost_perfomance_cgroup_memory_bytes");
+			body.label("kind", "headroom");
+			body.value(memory_statistics.MemoryHeadroom);
+		}
+	}
+#endif
+
+	void build_metrics(openmetrics_buffer& body) {
+		body.clear();
+		write_cpu_metrics(body);
+		write_memory_metrics(body);
+		write_scope_metrics(body);
+#ifdef __linux__
+		write_network_metrics(body);
+		write_interface_metrics(body);
+		write_cgroup_metrics(body);
+#endif
+		body.finish();
+	}
+
+	/*
+		pattern    
+	*/
+	static bool equals_ignore_case(const char* data, const char* pattern, std::size_t size) {
+		for (std::size_t i = 0; i < size; i++) {
+			char symbol = data[i];
+			if (symbol >= 'A' && symbol <= 'Z') symbol = (char)(symbol - 'A' + 'a');
+			if (symbol != pattern[i]) return false;
+		}
+
+		return true;
+	}
+
+	/*
+		     async_accept.    , 
+		    .
+	*/
+	void start_accept() {
+		if (is_accepting || is_stopped) return;
+
+		connection* free_connection = NULL;
+		for (std::size_t i = 0; i < connection_count; i++) {
+			if (!connections[i]->is_busy) {
+				free_connection = connections[i].get();
+				break;
+			}
+		}
+
+		if (!free_connection) return;
+
+		free_connection->is_busy = true;
+		is_accepting = true;
+		acceptor.async_accept(free_connection->socket, [this, free_connection](const boost::system::error_code& ec) {
+			is_accepting = false;
+			if (ec) {
+				free_connection->is_busy = false;
+				if (ec == boost::asio::error::operation_aborted) return;
+				return start_accept();
+			}
+
+			free_connection->start();
+			start_accept();
+		});
+	}
+
+public:
+	/*
+		    127.0.0.1.  asio   
+		  .
+	*/
+	openmetrics_exporter(boost::asio::io_context& io_context, unsigned short port,
+		const boost::asio::ip::address& address = boost::asio::ip::address_v4::loopback())
+		: strand(boost::asio::make_strand(io_context)), acceptor(strand, boost::asio::ip::tcp::endpoint(address, port)),
+		is_accepting(false), is_stopped(false) {
+		for (std::size_t i = 0; i < connection_count; i++) {
+			connections[i].reset(new connection(*this, strand));
+		}
+
+		core_load.reserve(cpu.get_cpu_count());
+		start_accept();
+	}
+
+	unsigned short get_port() const {
+		return acceptor.local_endpoint().port();
+	}
+
+	/*
+		     .   
+		io_context.
+	*/
+	void stop() {
+		boost::system::error_code ec;
+		is_stopped = true;
+		acceptor.close(ec);
+		for (std::size_t i = 0; i < connection_count; i++) {
+			connections[i]->stop();
+		}
+	}
+
+	/*
+		   HTTP,     
+	*/
+	const openmetrics_buffer& render() {
+		build_metrics(render_body);
+		return render_body;
+	}
+};
+
+}}}
+#endif
@@ -0,0 +1,33 @@
+#ifndef BOOST_PERFOMANCE_PLATFORM_HPP
+#define BOOST_PERFOMANCE_PLATFORM_HPP
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <boost/config.hpp>
+
+/*
+	     . ,    ,
+	      detail::platform.
+*/
+#if defined(BOOST_WINDOWS)
+#include "windows/cpu_counter.hpp"
+#include "windows/memory_counter.hpp"
+
+namespace boost { namespace perfomance { namespace detail {
+namespace platform = windows;
+}}}
+#elif defined(__linux__)
+#include "linux/cpu_counter.hpp"
+#include "linux/memory_counter.hpp"
+#include "linux/hw_counter.hpp"
+
+namespace boost { namespace perfomance { namespace detail {
+namespace platform = linux_;
+}}}
+#else
+#error "Boost.Perfomance: unsupported platform"
+#endif
+
+#endif
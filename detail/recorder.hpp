@@ -0,0 +1,587 @@
+#ifndef BOOST_PERFOMANCE_RECORDER_HPP
+#define BOOST_PERFOMANCE_RECORDER_HPP
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <fstream>
+#include <algorithm>
+#include <boost/cstdint.hpp>
+#include <boost/chrono.hpp>
+#include <boost/container/vector.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/interprocess/exceptions.hpp>
+
+namespace boost { namespace perfomance { namespace detail {
+
+/*
+	  :
+
+		[][ ][ 0][ 1]...[ N-1]
+
+	         ,  
+	  -       .  
+	:   ,    ,  
+	   N  .
+
+	  -   ChannelCount ,    Quantum, 
+	    TimeResolution .    
+	 ,   -  ;     
+	        (   
+	 ).   - zigzag varint,       .
+	     ,   .
+*/
+typedef struct {
+	char Magic[8];							// "BPRFREC"
+	boost::uint32_t Version;
+	boost::uint32_t ByteOrder;				// 0x01020304    
+	boost::uint32_t ChannelCount;
+	boost::uint32_t BlockSize;
+	boost::uint32_t BlockCount;
+	boost::uint32_t Reserved;
+	double Quantum;							//  =  * Quantum
+	boost::uint64_t TimeResolution;			//     
+	boost::uint64_t NextSequence;			//   ,   1
+} RecordHeaderStruct;
+
+typedef struct {
+	boost::uint64_t Sequence;				// 0 -    
+	boost::uint64_t FirstTimestamp;			// ,   
+	boost::uint64_t LastTimestamp;
+	boost::uint32_t Size;					//   
+	boost::uint32_t SampleCount;
+} RecordBlockStruct;
+
+namespace record_encoding {
+
+enum {
+	version = 1,
+	byte_order = 0x01020304,
+	max_varint_size = 10,
+	data_alignment = 4096
+};
+
+inline boost::uint64_t zigzag(boost::int64_t value) {
+	return ((boost::uint64_t)value << 1) ^ (boost::uint64_t)(value >> 63);
+}
+
+inline boost::int64_t unzigzag(boost::uint64_t value) {
+	return (boost::int64_t)(value >> 1) ^ -(boost::int64_t)(value & 1);
+}
+
+inline unsigned char* write_varint(unsigned char* cur, boost::uint64_t value) {
+	while (value >= 0x80) {
+		*cur++ = (unsigned char)(value | 0x80);
+		value >>= 7;
+	}
+
+	*cur++ = (unsigned char)value;
+	return cur;
+}
+
+inline bool read_varint(const unsigned char*& cur, const unsigned char* end, boost::uint64_t& value) {
+	value = 0;
+	for (unsigned int shift = 0; cur < end && shift < 64; shift += 7) {
+		unsigned char byte = *cur++;
+		value |= (boost::uint64_t)(byte & 0x7f) << shift;
+		if (!(byte & 0x80)) return true;
+	}
+
+	return false;
+}
+
+inline std::size_t index_offset() {
+	return (sizeof(RecordHeaderStruct) + 63) & ~(std::size_t)63;
+}
+
+inline std::size_t data_offset(std::size_t block_count) {
+	std::size_t offset = index_offset() + block_count * sizeof(RecordBlockStruct);
+	return (offset + data_alignment - 1) & ~(std::size_t)(data_alignment - 1);
+}
+
+inline bool check_header(const RecordHeaderStruct& header, std::size_t file_size) {
+	if (file_size < sizeof(RecordHeaderStruct)) return false;
+	if (std::memcmp(header.Magic, "BPRFREC", 8) || header.Version != version || header.ByteOrder != byte_order) return false;
+	if (!header.ChannelCount || !header.BlockCount || !header.TimeResolution || !(header.Quantum > 0.0)) return false;
+	if (header.BlockSize < max_varint_size * (header.ChannelCount + 1)) return false;
+
+	return data_offset(header.BlockCount) + (std::size_t)header.BlockCount * header.BlockSize <= file_size;
+}
+
+inline std::size_t file_size(const RecordHeaderStruct& header) {
+	return data_offset(header.BlockCount) + (std::size_t)header.BlockCount * header.BlockSize;
+}
+
+}
+
+/*
+	      .    , 
+	append   .         
+	,     ,    .
+
+	    : open    
+	,    retention_seconds. , 24   10   9 
+	(8    ) - 864000 ,  17  .
+*/
+class recorder {
+private:
+	boost::interprocess::file_mapping file;
+	boost::interprocess::mapped_region region;
+
+	RecordHeaderStruct* header;
+	RecordBlockStruct* blocks;
+	unsigned char* data;
+
+	RecordBlockStruct* current_block;
+	unsigned char* write_cursor;
+	unsigned char* block_end;
+	std::size_t max_sample_size;
+
+	boost::uint64_t block_timestamp;
+	boost::uint64_t prev_ticks;
+	boost::int64_t prev_delta;
+	boost::container::vector<boost::int64_t> prev_values;
+
+	recorder(const recorder&);
+	recorder& operator=(const recorder&);
+
+	enum {
+		estimated_value_size = 2,
+		default_block_size = 65536
+	};
+
+	static bool create_file(const char* path, std::size_t size) {
+		std::filebuf buffer;
+		if (!buffer.open(path, std::ios_base::in | std::ios_base::out | std::ios_base::trunc | std::ios_base::binary)) return false;
+
+		/*
+			     ,   
+			     
+		*/
+		if (buffer.pubseekoff((std::streamoff)size - 1, std::ios_base::beg) == std::streampos(std::streamoff(-1))) return false;
+		return buffer.sputc(0) == 0 && buffer.close() != NULL;
+	}
+
+	static bool matches(const RecordHeaderStruct& existing, const RecordHeaderStruct& expected, std::size_t file_size) {
+		return record_encoding::check_header(existing, file_size) && existing.ChannelCount == expected.ChannelCount &&
+			existing.BlockSize == expected.BlockSize && existing.BlockCount == expected.BlockCount &&
+			existing.Quantum == expected.Quantum && existing.TimeResolution == expected.TimeResolution;
+	}
+
+	bool map_file(const char* path) {
+		try {
+			boost::interprocess::file_mapping mapping(path, boost::interprocess::read_write);
+			boost::interprocess::mapped_region mapped(mapping, boost::interprocess::read_write);
+			file.swap(mapping);
+			region.swap(mapped);
+		} catch (const boost::interprocess::interprocess_exception&) {
+			return false;
+		}
+
+		return true;
+	}
+
+	template <class T>
+	static boost::int64_t quantize(T value, double quantum) {
+		double scaled = (double)value / quantum;
+		if (!(scaled == scaled)) return 0;
+		if (scaled > 9.2e18) return (boost::int64_t)9.2e18;
+		if (scaled < -9.2e18) return -(boost::int64_t)9.2e18;
+		return (boost::int64_t)std::llround(scaled);
+	}
+
+	/*
+		     . SampleCount  :  
+		  ,       .
+	*/
+	void start_block(boost::uint64_t timestamp) {
+		boost::uint64_t sequence = header->NextSequence++;
+		std::size_t slot = (std::size_t)((sequence - 1) % header->BlockCount);
+
+		current_block = &blocks[slot];
+		current_block->SampleCount = 0;
+		current_block->Size = 0;
+		current_block->Sequence = sequence;
+		current_block->FirstTimestamp = timestamp;
+		current_block->LastTimestamp = timestamp;
+
+		write_cursor = data + slot * (std::size_t)header->BlockSize;
+		block_end = write_cursor + header->BlockSize;
+		block_timestamp = timestamp;
+		prev_ticks = 0;
+		prev_delta = 0;
+	}
+
+public:
+	recorder() : header(NULL), blocks(NULL), data(NULL), current_block(NULL), write_cursor(NULL), block_end(NULL), max_sample_size(0),
+		block_timestamp(0), prev_ticks(0), prev_delta(0) {}
+
+	/*
+		channel_count -   , sample_rate -   ,
+		retention_seconds -      .
+
+		    estimated_value_size   .   0.01 
+		   0..1 -   100 ,     
+		 varint,     64     .  
+		   ,   .
+	*/
+	bool open(const char* path, std::size_t channel_count, double sample_rate, double retention_seconds, double quantum = 0.01) {
+		if (!channel_count || !(sample_rate > 0.0) || !(retention_seconds > 0.0)) return false;
+
+		std::size_t max_size = record_encoding::max_varint_size * (channel_count + 1);
+		double history_size = std::ceil(sample_rate * retention_seconds) * (double)(estimated_value_size * (channel_count + 1));
+
+		/*
+			 -    ,     default_block_size,
+			      
+		*/
+		double block_size = std::ceil(history_size / 16 / record_encoding::data_alignment) * record_encoding::data_alignment;
+		if (block_size > default_block_size) block_size = default_block_size;
+		if (block_size < record_encoding::data_alignment) block_size = record_encoding::data_alignment;
+		if (block_size < 4.0 * max_size) block_size = std::ceil(4.0 * max_size / record_encoding::data_alignment) * record_encoding::data_alignment;
+
+		double block_count = std::ceil(history_size / (block_size - max_size)) + 1;
+		if (block_count > 0xffffffffu || block_size > 0xffffffffu) return false;
+
+		return open_blocks(path, channel_count, quantum, (std::size_t)block_count, (std::size_t)block_size);
+	}
+
+	/*
+		    : block_count * block_size -  ,
+		time_resolution -    
+	*/
+	bool open_blocks(const char* path, std::size_t channel_count, double quantum, std::size_t block_count,
+		std::size_t block_size, boost::uint64_t time_resolution = 1000000) {
+		close();
+
+		RecordHeaderStruct expected;
+		std::memset(&expected, 0, sizeof(expected));
+		std::memcpy(expected.Magic, "BPRFREC", 8);
+		expected.Version = record_encoding::version;
+		expected.ByteOrder = record_encoding::byte_order;
+		expected.ChannelCount = (boost::uint32_t)channel_count;
+		expected.BlockSize = (boost::uint32_t)block_size;
+		expected.BlockCount = (boost::uint32_t)block_count;
+		expected.Quantum = quantum;
+		expected.TimeResolution = time_resolution;
+		expected.NextSequence = 1;
+
+		if (!channel_count || !block_count || !(quantum > 0.0) || !time_resolution) return false;
+		if (block_size > 0xffffffffu || block_size < record_encoding::max_varint_size * (channel_count + 1)) return false;
+
+		std::size_t size = record_encoding::file_size(expected);
+		if (!map_file(path) || !matches(*(const RecordHeaderStruct*)region.get_address(), expected, region.get_size())) {
+			close();
+			if (!create_file(path, size) || !map_file(path)) return false;
+			std::memcpy(region.get_address(), &expected, sizeof(expected));
+		}
+
+		unsigned char* base = (unsigned char*)region.get_address();
+		header = (RecordHeaderStruct*)base;
+		blocks = (RecordBlockStruct*)(base + record_encoding::index_offset());
+		data = base + record_encoding::data_offset(header->BlockCount);
+		max_sample_size = record_encoding::max_varint_size * (channel_count + 1);
+		prev_values.assign(channel_count, 0);
+		return true;
+	}
+
+	bool is_open() const {
+		return header != NULL;
+	}
+
+	void close() {
+		boost::interprocess::mapped_region().swap(region);
+		boost::interprocess::file_mapping().swap(file);
+		header = NULL;
+		blocks = NULL;
+		data = NULL;
+		current_block = NULL;
+	}
+
+	std::size_t get_channel_count() const {
+		return prev_values.size();
+	}
+
+	/*
+		   get_channel_count() . timestamp -  (
+		system_clock),   .
+	*/
+	template <class T>
+	bool append(boost::uint64_t timestamp, const T* values) {
+		if (!header || (current_block && timestamp < current_block->LastTimestamp)) return false;
+
+		if (!current_block || (std::size_t)(block_end - write_cursor) < max_sample_size) {
+			start_block(timestamp);
+			for (std::size_t i = 0; i < prev_values.size(); i++) {
+				prev_values[i] = quantize(values[i], header->Quantum);
+				write_cursor = record_encoding::write_varint(write_cursor, record_encoding::zigzag(prev_values[i]));
+			}
+		} else {
+			boost::uint64_t ticks = (timestamp - block_timestamp) / header->TimeResolution;
+			boost::int64_t delta = (boost::int64_t)(ticks - prev_ticks);
+			write_cursor = record_encoding::write_varint(write_cursor, record_encoding::zigzag(delta - prev_delta));
+			prev_delta = delta;
+			prev_ticks = ticks;
+
+			for (std::size_t i = 0; i < prev_values.size(); i++) {
+				boost::int64_t value = quantize(values[i], header->Quantum);
+				write_cursor = record_encoding::write_varint(write_cursor, record_encoding::zigzag(value - prev_values[i]));
+				prev_values[i] = value;
+			}
+		}
+
+		/*
+			SampleCount  :      
+		*/
+		current_block->Size = (boost::uint32_t)(write_cursor - (block_end - header->BlockSize));
+		current_block->LastTimestamp = block_timestamp + prev_ticks * header->TimeResolution;
+		current_block->SampleCount++;
+		return true;
+	}
+
+	bool append(const float* values) {
+		return append((boost::uint64_t)boost::chrono::duration_cast<boost::chrono::nanoseconds>(
+			boost::chrono::system_clock::now().time_since_epoch()).count(), values);
+	}
+
+	/*
+		    (msync).     :    
+		 ,     .
+	*/
+	bool flush(bool async = true) {
+		return header && region.flush(0, 0, async);
+	}
+};
+
+/*
+	  .      , seek  
+	   ,  next   .
+*/
+class record_reader {
+private:
+	boost::interprocess::file_mapping file;
+	boost::interprocess::mapped_region region;
+
+	const RecordHeaderStruct* header;
+	const RecordBlockStruct* blocks;
+	const unsigned char* data;
+	boost::container::vector<std::size_t> block_order;
+
+	/*
+		 .       ,   
+		      .
+	*/
+	std::size_t order_index;
+	const unsigned char* cursor;
+	const unsigned char* cursor_end;
+	boost::uint32_t samples_left;
+	boost::uint32_t samples_read;
+	boost::uint64_t block_timestamp;
+	boost::uint64_t ticks;
+	boost::int64_t delta;
+	boost::container::vector<boost::int64_t> values;
+
+	/*
+		seek    , next   
+	*/
+	bool has_pending;
+	boost::uint64_t pending_timestamp;
+
+	record_reader(const record_reader&);
+	record_reader& operator=(const record_reader&);
+
+	struct sequence_less {
+		const RecordBlockStruct* blocks;
+
+		explicit sequence_less(const RecordBlockStruct* index) : blocks(index) {}
+
+		bool operator()(std::size_t left, std::size_t right) const {
+			return blocks[left].Sequence < blocks[right].Sequence;
+		}
+	};
+
+	bool enter_block(std::size_t index) {
+		order_index = index;
+		if (order_index >= block_order.size()) return false;
+
+		std::size_t slot = block_order[order_index];
+		const RecordBlockStruct& block = blocks[slot];
+
+		std::size_t size = block.Size < header->BlockSize ? block.Size : header->BlockSize;
+		cursor = data + slot * (std::size_t)header->BlockSize;
+		cursor_end = cursor + size;
+		samples_left = block.SampleCount;
+		samples_read = 0;
+		block_timestamp = block.FirstTimestamp;
+		ticks = 0;
+		delta = 0;
+		return true;
+	}
+
+	bool decode(boost::uint64_t& timestamp) {
+		for (;;) {
+			if (samples_left) break;
+			if (!enter_block(order_index + 1)) return false;
+		}
+
+		boost::uint64_t encoded = 0;
+		if (samples_read) {
+			if (!record_encoding::read_varint(cursor, cursor_end, encoded)) return skip_block(timestamp);
+			delta += record_encoding::unzigzag(encoded);
+			ticks += (boost::uint64_t)delta;
+		}
+
+		for (std::size_t i = 0; i < values.size(); i++) {
+			if (!record_encoding::read_varint(cursor, cursor_end, encoded)) return skip_block(timestamp);
+			values[i] = samples_read ? values[i] + record_encoding::unzigzag(encoded) : record_encoding::unzigzag(encoded);
+		}
+
+		samples_left--;
+		samples_read++;
+		timestamp = block_timestamp + ticks * header->TimeResolution;
+		return true;
+	}
+
+	/*
+		        
+	*/
+	bool skip_block(boost::uint64_t& timestamp) {
+		samples_left = 0;
+		return decode(timestamp);
+	}
+
+public:
+	record_reader() : header(NULL), blocks(NULL), data(NULL), order_index(0), cursor(NULL), cursor_end(NULL), samples_left(0),
+		samples_read(0), block_timestamp(0), ticks(0), delta(0), has_pending(false), pending_timestamp(0) {}
+
+	bool open(const char* path) {
+		close();
+
+		try {
+			boost::interprocess::file_mapping mapping(path, boost::interprocess::read_only);
+			boost::interprocess::mapped_region mapped(mapping, boost::interprocess::read_only);
+			file.swap(mapping);
+			region.swap(mapped);
+		} catch (const boost::interprocess::interprocess_exception&) {
+			return false;
+		}
+
+		const unsigned char* base = (const unsigned char*)region.get_address();
+		if (!record_encoding::check_header(*(const RecordHeaderStruct*)base, region.get_size())) {
+			close();
+			return false;
+		}
+
+		header = (const RecordHeaderStruct*)base;
+		blocks = (const RecordBlockStruct*)(base + record_encoding::index_offset());
+		data = base + record_encoding::data_offset(header->BlockCount);
+		values.assign(header->ChannelCount, 0);
+
+		for (std::size_t slot = 0; slot < header->BlockCount; slot++) {
+			if (blocks[slot].Sequence && blocks[slot].SampleCount) block_order.push_back(slot);
+		}
+
+		std::sort(block_order.begin(), block_order.end(), sequence_less(blocks));
+		rewind();
+		return true;
+	}
+
+	void close() {
+		boost::interprocess::mapped_region().swap(region);
+		boost::interprocess::file_mapping().swap(file);
+		header = NULL;
+		blocks = NULL;
+		data = NULL;
+		block_order.clear();
+		samples_left = 0;
+		has_pending = false;
+	}
+
+	bool is_open() const {
+		return header != NULL;
+	}
+
+	std::size_t get_channel_count() const {
+		return values.size();
+	}
+
+	std::size_t get_block_count() const {
+		return block_order.size();
+	}
+
+	const RecordHeaderStruct* get_header() const {
+		return header;
+	}
+
+	/*
+		      
+	*/
+	bool get_time_range(boost::uint64_t& first, boost::uint64_t& last) const {
+		if (block_order.empty()) return false;
+
+		first = blocks[block_order.front()].FirstTimestamp;
+		last = blocks[block_order.back()].LastTimestamp;
+		return true;
+	}
+
+	void rewind() {
+		has_pending = false;
+		if (!enter_block(0)) samples_left = 0;
+	}
+
+	/*
+		         timestamp
+	*/
+	bool seek(boost::uint64_t timestamp) {
+		has_pending = false;
+		std::size_t low = 0;
+		std::size_t high = block_order.size();
+		while (low < high) {
+			std::size_t middle = (low + high) / 2;
+			if (blocks[block_order[middle]].LastTimestamp < timestamp) low = middle + 1;
+			else high = middle;
+		}
+
+		if (!enter_block(low)) {
+			samples_left = 0;
+			return false;
+		}
+
+		for (;;) {
+			if (!decode(pending_timestamp)) return false;
+			if (pending_timestamp >= timestamp) break;
+		}
+
+		has_pending = true;
+		return true;
+	}
+
+	/*
+		 : timestamp    get_channel_count() 
+	*/
+	template <class T>
+	bool next(boost::uint64_t& timestamp, T* sample_values) {
+		if (!header) return false;
+
+		if (has_pending) {
+			timestamp = pending_timestamp;
+			has_pending = false;
+		} else if (!decode(timestamp)) {
+			return false;
+		}
+
+		for (std::size_t i = 0; i < values.size(); i++) {
+			sample_values[i] = (T)((double)values[i] * header->Quantum);
+		}
+
+		return true;
+	}
+};
+
+}}}
+#endif
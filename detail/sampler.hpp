@@ -0,0 +1,255 @@
+#ifndef BOOST_PERFOMANCE_SAMPLER_HPP
+#define BOOST_PERFOMANCE_SAMPLER_HPP
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <cstdlib>
+#include <algorithm>
+#include <boost/cstdint.hpp>
+#include <boost/atomic.hpp>
+#include <boost/chrono.hpp>
+#include <boost/container/vector.hpp>
+#include <boost/thread.hpp>
+#include <boost/scoped_ptr.hpp>
+#include "seqlock.hpp"
+#include "load_history.hpp"
+#include "recorder.hpp"
+
+namespace boost { namespace perfomance { namespace detail {
+
+/*
+	   .        
+	  ,  get_load  get_load_per_core   
+	 ,        .
+*/
+template <class CpuCounter>
+class basic_cpu_sampler {
+private:
+	CpuCounter counter;
+	boost::chrono::milliseconds period;
+	boost::container::vector<float> core_load;
+
+	/*
+		     seqlock,    get_load 
+		 -,       
+	*/
+	seqlock<float> base_snapshot;
+	seqlock<float> core_snapshot;
+	boost::scoped_ptr<load_history> history;
+
+	/*
+		  :      ,   load_history
+	*/
+	boost::mutex recorder_mutex;
+	recorder* record_target;
+	boost::container::vector<float> record_row;
+	boost::thread sampler_thread;
+
+	basic_cpu_sampler(const basic_cpu_sampler&);
+	basic_cpu_sampler& operator=(const basic_cpu_sampler&);
+
+	static std::size_t prime_counter(CpuCounter& cpu, boost::container::vector<float>& load) {
+		/*
+			         
+			 ,     
+		*/
+		if (!cpu.get_load_per_core(load)) load.clear();
+		return load.size();
+	}
+
+	void sample() {
+		float base_load = 0.f;
+		if (!counter.get_load_per_core(core_load, base_load) || core_load.size() != core_snapshot.size()) return;
+
+		core_snapshot.store(&core_load[0]);
+		base_snapshot.store(&base_load);
+		if (history) history->push(core_load);
+
+		boost::lock_guard<boost::mutex> lock(recorder_mutex);
+		if (record_target) {
+			std::copy(core_load.begin(), core_load.end(), record_row.begin());
+			record_row.back() = base_load;
+			record_target->append(record_row.data());
+		}
+	}
+
+	void sampler_proc() {
+		boost::chrono::steady_clock::time_point next_tick = boost::chrono::steady_clock::now();
+
+		try {
+			for (;;) {
+				next_tick += period;
+				boost::this_thread::sleep_until(next_tick);
+				sample();
+			}
+		} catch (const boost::thread_interrupted&) {
+		}
+	}
+
+public:
+	explicit basic_cpu_sampler(boost::chrono::milliseconds sample_period = boost::chrono::milliseconds(100))
+		: period(sample_period), base_snapshot(1), core_snapshot(prime_counter(counter, core_load)), record_target(NULL),
+		record_row(core_snapshot.size() + 1) {
+		if (core_snapshot.size()) {
+			sampler_thread = boost::thread(&basic_cpu_sampler::sampler_proc, this);
+		}
+	}
+
+	/*
+		  : history_windows -   ( 1, 10  60 ),
+		     , ,   
+	*/
+	basic_cpu_sampler(boost::chrono::milliseconds sample_period, const boost::chrono::milliseconds* history_windows, std::size_t history_window_count)
+		: period(sample_period), base_snapshot(1), core_snapshot(prime_counter(counter, core_load)), record_target(NULL),
+		record_row(core_snapshot.size() + 1) {
+		if (!core_snapshot.size()) return;
+
+		boost::container::vector<std::size_t> window_ticks(history_window_count);
+		for (std::size_t i = 0; i < history_window_count; i++) {
+			window_ticks[i] = period.count() > 0 ? (std::size_t)(history_windows[i].count() / period.count()) : 1;
+		}
+
+		if (history_window_count) history.reset(new load_history(core_snapshot.size(), window_ticks.data(), history_window_count));
+		sampler_thread = boost::thread(&basic_cpu_sampler::sampler_proc, this);
+	}
+
+	~basic_cpu_sampler() {
+		if (sampler_thread.joinable()) {
+			sampler_thread.interrupt();
+			sampler_thread.join();
+		}
+	}
+
+	/*
+		 false   ,      
+	*/
+	bool get_load(float& base_load) const {
+		return base_snapshot.load(&base_load);
+	}
+
+	bool get_load_per_core(boost::container::vector<float>& vector_load) const {
+		if (!core_snapshot.size()) return false;
+
+		vector_load.resize(core_snapshot.size());
+		return core_snapshot.load(&vector_load[0]);
+	}
+
+	std::size_t get_core_count() const {
+		return core_snapshot.size();
+	}
+
+	/*
+		     target. recorder    
+		get_core_count() + 1 ;  attach_recorder(NULL)    
+		     .
+	*/
+	bool attach_recorder(recorder* target) {
+		if (target && target->get_channel_count() != core_snapshot.size() + 1) return false;
+
+		boost::lock_guard<boost::mutex> lock(recorder_mutex);
+		record_target = target;
+		return true;
+	}
+
+	bool get_rolling_load(std::size_t window_index, RollingLoadStruct& stats) const {
+		return history && history->get_rolling_load(window_index, stats);
+	}
+
+	bool get_rolling_load(std::size_t window_index, std::size_t core_index, RollingLoadStruct& stats) const {
+		return history && history->get_rolling_load(window_index, core_index, stats);
+	}
+};
+
+typedef struct {
+	unsigned long long SwapLoad;
+	unsigned long long VirtualMemoryLoad;
+	unsigned long long ProcessSwapLoad;
+	unsigned long long ProcessVirtualMemoryLoad;
+} MemorySnapshotStruct;
+
+/*
+	     :    
+	 ,          
+*/
+template <class MemoryCounter>
+class basic_memory_sampler {
+private:
+	MemoryCounter counter;
+	boost::chrono::milliseconds period;
+	seqlock<MemorySnapshotStruct> snapshot;
+	boost::thread sampler_thread;
+
+	basic_memory_sampler(const basic_memory_sampler&);
+	basic_memory_sampler& operator=(const basic_memory_sampler&);
+
+	void sample() {
+		MemorySnapshotStruct memory_snapshot = {};
+
+		if (!counter.get_system_memory_load(memory_snapshot.SwapLoad, memory_snapshot.VirtualMemoryLoad)) return;
+		if (!counter.get_process_swap_load(memory_snapshot.ProcessSwapLoad)) return;
+		if (!counter.get_process_vmemory_load(memory_snapshot.ProcessVirtualMemoryLoad)) return;
+
+		snapshot.store(&memory_snapshot);
+	}
+
+	void sampler_proc() {
+		boost::chrono::steady_clock::time_point next_tick = boost::chrono::steady_clock::now();
+
+		try {
+			for (;;) {
+				sample();
+				next_tick += period;
+				boost::this_thread::sleep_until(next_tick);
+			}
+		} catch (const boost::thread_interrupted&) {
+		}
+	}
+
+public:
+	explicit basic_memory_sampler(boost::chrono::milliseconds sample_period = boost::chrono::milliseconds(100))
+		: period(sample_period), snapshot(1) {
+		sampler_thread = boost::thread(&basic_memory_sampler::sampler_proc, this);
+	}
+
+	~basic_memory_sampler() {
+		sampler_thread.interrupt();
+		sampler_thread.join();
+	}
+
+	bool get_snapshot(MemorySnapshotStruct& memory_snapshot) const {
+		return snapshot.load(&memory_snapshot);
+	}
+
+	bool get_swap_load(unsigned long long& swap_load) const {
+		MemorySnapshotStruct memory_snapshot;
+		if (!snapshot.load(&memory_snapshot)) return false;
+		swap_load = memory_snapshot.SwapLoad;
+		return true;
+	}
+
+	bool get_vmemory_load(unsigned long long& mem_load) const {
+		MemorySnapshotStruct memory_snapshot;
+		if (!snapshot.load(&memory_snapshot)) return false;
+		mem_load = memory_snapshot.VirtualMemoryLoad;
+		return true;
+	}
+
+	bool get_process_swap_load(unsigned long long& swap_load) const {
+		MemorySnapshotStruct memory_snapshot;
+		if (!snapshot.load(&memory_snapshot)) return false;
+		swap_load = memory_snapshot.ProcessSwapLoad;
+		return true;
+	}
+
+	bool get_process_vmemory_load(unsigned long long& mem_load) const {
+		MemorySnapshotStruct memory_snapshot;
+		if (!snapshot.load(&memory_snapshot)) return false;
+		mem_load = memory_snapshot.ProcessVirtualMemoryLoad;
+		return true;
+	}
+};
+
+}}}
+#endif
@@ -0,0 +1,407 @@
+#ifndef BOOST_PERFOMANCE_SCOPE_TIMER_HPP
+#define BOOST_PERFOMANCE_SCOPE_TIMER_HPP
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <cstdlib>
+#include <boost/config.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/atomic.hpp>
+#include <boost/chrono.hpp>
+#include <boost/thread.hpp>
+#include <boost/container/vector.hpp>
+#include <boost/container/flat_map.hpp>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#include <cpuid.h>
+#define BOOST_PERFOMANCE_HAS_TSC
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define BOOST_PERFOMANCE_HAS_TSC
+#endif
+
+namespace boost { namespace perfomance { namespace detail {
+
+/*
+	    TSC.    ,   
+	      ,   
+	       .
+*/
+class tsc_clock {
+private:
+	static bool detect_invariant_tsc() {
+#if defined(BOOST_PERFOMANCE_HAS_TSC) && (defined(__x86_64__) || defined(__i386__))
+		unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+		if (!__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) || eax < 0x80000007) return false;
+		if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) return false;
+		return (edx & (1u << 8)) != 0;
+#elif defined(BOOST_PERFOMANCE_HAS_TSC)
+		int registers[4] = {};
+		__cpuid(registers, 0x80000000);
+		if ((unsigned int)registers[0] < 0x80000007) return false;
+		__cpuid(registers, 0x80000007);
+		return (registers[3] & (1 << 8)) != 0;
+#else
+		return false;
+#endif
+	}
+
+	static boost::uint64_t steady_nanoseconds() {
+		return (boost::uint64_t)boost::chrono::duration_cast<boost::chrono::nanoseconds>(
+			boost::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	static double calibrate() {
+		if (!is_invariant()) return 1.0;
+
+		/*
+			10  ,         
+		*/
+		boost::uint64_t steady_begin = steady_nanoseconds();
+		boost::uint64_t tsc_begin = now();
+		boost::uint64_t steady_end = steady_begin;
+
+		while (steady_end - steady_begin < 10000000) {
+			steady_end = steady_nanoseconds();
+		}
+
+		boost::uint64_t tsc_end = now();
+		if (tsc_end == tsc_begin) return 1.0;
+		return (double)(steady_end - steady_begin) / (double)(tsc_end - tsc_begin);
+	}
+
+public:
+	static bool is_invariant() {
+		static const bool invariant = detect_invariant_tsc();
+		return invariant;
+	}
+
+	/*
+		  TSC ,     
+	*/
+	static boost::uint64_t now() {
+#ifdef BOOST_PERFOMANCE_HAS_TSC
+		if (is_invariant()) return __rdtsc();
+#endif
+		return steady_nanoseconds();
+	}
+
+	static double nanoseconds_per_tick() {
+		static const double ratio = calibrate();
+		return ratio;
+	}
+};
+
+typedef struct {
+	const char* Name;
+	boost::uint64_t Begin;
+	boost::uint64_t End;
+} ScopeRecordStruct;
+
+typedef struct {
+	const char* Name;
+	unsigned long long Count;
+	double TotalNanoseconds;
+	double MinNanoseconds;
+	double MaxNanoseconds;
+} ScopeStatisticsStruct;
+
+/*
+	   :  -  ,  - -.
+	   ,       ,
+	    .
+*/
+class scope_buffer {
+public:
+	enum {
+		capacity = 4096,
+		index_mask = capacity - 1
+	};
+
+private:
+	BOOST_ALIGNMENT(64) boost::atomic<std::size_t> write_index;
+	std::size_t cached_read_index;
+	boost::atomic<unsigned long long> dropped_records;
+
+	BOOST_ALIGNMENT(64) boost::atomic<std::size_t> read_index;
+	boost::atomic<bool> retired;
+
+	ScopeRecordStruct records[capacity];
+
+	scope_buffer(const scope_buffer&);
+	scope_buffer& operator=(const scope_buffer&);
+
+public:
+	scope_buffer() : write_index(0), cached_read_index(0), dropped_records(0), read_index(0), retired(false) {}
+
+	void push(const char* name, boost::uint64_t begin, boost::uint64_t end) {
+		std::size_t write_position = write_index.load(boost::memory_order_relaxed);
+
+		if (write_position - cached_read_index >= capacity) {
+			cached_read_index = read_index.load(boost::memory_order_acquire);
+			if (write_position - cached_read_index >= capacity) {
+				dropped_records.store(dropped_records.load(boost::memory_order_relaxed) + 1, boost::memory_order_relaxed);
+				return;
+			}
+		}
+
+		ScopeRecordStruct& record = records[write_position & index_mask];
+		record.Name = name;
+		record.Begin = begin;
+		record.End = end;
+		write_index.store(write_position + 1, boost::memory_order_release);
+	}
+
+	/*
+		  
+	*/
+	template <class Consumer>
+	void drain(Consumer& consumer) {
+		std::size_t read_position = read_index.load(boost::memory_order_relaxed);
+		std::size_t write_position = write_index.load(boost::memory_order_acquire);
+
+		for (; read_position != write_position; read_position++) {
+			consumer(records[read_position & index_mask]);
+		}
+
+		read_index.store(read_position, boost::memory_order_release);
+	}
+
+	unsigned long long get_dropped_records() const {
+		return dropped_records.load(boost::memory_order_relaxed);
+	}
+
+	void retire() {
+		retired.store(true, boost::memory_order_release);
+	}
+
+	bool is_retired() const {
+		return retired.load(boost::memory_order_acquire);
+	}
+};
+
+/*
+	       .  
+	  ,  ,     main, 
+	   .
+*/
+class scope_registry {
+private:
+	typedef struct {
+		unsigned long long Count;
+		boost::uint64_t TotalTicks;
+		boost::uint64_t MinTicks;
+		boost::uint64_t MaxTicks;
+	} ScopeTicksStruct;
+
+	typedef boost::container::flat_map<const char*, ScopeTicksStruct> statistics_map;
+
+	boost::mutex buffers_mutex;
+	boost::container::vector<scope_buffer*> buffers;
+	unsigned long long retired_dropped_records;
+
+	boost::mutex statistics_mutex;
+	statistics_map statistics;
+
+	boost::mutex collector_mutex;
+	boost::thread collector_thread;
+
+	/*
+		     : 0 -   
+		, 1 -    
+	*/
+	enum {
+		retired_thread = 1
+	};
+
+	static scope_buffer*& cached_thread_buffer() {
+		static thread_local scope_buffer* buffer = NULL;
+		return buffer;
+	}
+
+	/*
+		   thread_local,     
+		   .      
+		  thread_local ,      .
+		    :  retire   
+		   ,        thread_local
+		   atexit.
+	*/
+	struct thread_buffer_holder {
+		scope_buffer* buffer;
+
+		thread_buffer_holder() : buffer(NULL) {}
+		~thread_buffer_holder() {
+			if (!buffer) return;
+
+			cached_thread_buffer() = reinterpret_cast<scope_buffer*>((std::size_t)retired_thread);
+			buffer->retire();
+		}
+	};
+
+	struct statistics_consumer {
+		statistics_map& target;
+
+		explicit statistics_consumer(statistics_map& map) : target(map) {}
+
+		void operator()(const ScopeRecordStruct& record) {
+			boost::uint64_t ticks = record.End - record.Begin;
+			ScopeTicksStruct& stats = target[record.Name];
+
+			if (!stats.Count || ticks < stats.MinTicks) stats.MinTicks = ticks;
+			if (ticks > stats.MaxTicks) stats.MaxTicks = ticks;
+			stats.TotalTicks += ticks;
+			stats.Count++;
+		}
+	};
+
+	scope_registry() : retired_dropped_records(0) {}
+
+	void collector_proc(boost::chrono::milliseconds period) {
+		try {
+			for (;;) {
+				boost::this_thread::sleep_for(period);
+				collect();
+			}
+		} catch (const boost::thread_interrupted&) {
+		}
+	}
+
+public:
+	static scope_registry& instance() {
+		static scope_registry* registry = new scope_registry();
+		return *registry;
+	}
+
+	/*
+		    NULL,        ,
+		  .      .
+	*/
+	static scope_buffer* thread_buffer() {
+		scope_buffer*& buffer = cached_thread_buffer();
+		if (BOOST_UNLIKELY((std::size_t)buffer <= retired_thread)) {
+			if (buffer) return NULL;
+			buffer = instance().register_thread();
+		}
+
+		return buffer;
+	}
+
+	/*
+		         
+	*/
+	scope_buffer* register_thread() {
+		static thread_local thread_buffer_holder holder;
+		scope_buffer* buffer = new scope_buffer();
+
+		boost::lock_guard<boost::mutex> lock(buffers_mutex);
+		buffers.push_back(buffer);
+		holder.buffer = buffer;
+		return buffer;
+	}
+
+	/*
+		     .   
+		  ,      .
+	*/
+	void collect() {
+		boost::lock_guard<boost::mutex> buffers_lock(buffers_mutex);
+		boost::lock_guard<boost::mutex> statistics_lock(statistics_mutex);
+		statistics_consumer consumer(statistics);
+
+		for (std::size_t i = 0; i < buffers.size();) {
+			bool retired = buffers[i]->is_retired();
+			buffers[i]->drain(consumer);
+
+			if (retired) {
+				retired_dropped_records += buffers[i]->get_dropped_records();
+				delete buffers[i];
+				buffers.erase(buffers.begin() + i);
+			} else {
+				i++;
+			}
+		}
+	}
+
+	void start_collector(boost::chrono::milliseconds period) {
+		boost::lock_guard<boost::mutex> lock(collector_mutex);
+		if (collector_thread.joinable()) return;
+
+		/*
+			   10 ,    
+		*/
+		tsc_clock::nanoseconds_per_tick();
+		collector_thread = boost::thread(&scope_registry::collector_proc, this, period);
+	}
+
+	void stop_collector() {
+		boost::lock_guard<boost::mutex> lock(collector_mutex);
+		if (!collector_thread.joinable()) return;
+
+		collector_thread.interrupt();
+		collector_thread.join();
+	}
+
+	void get_statistics(boost::container::vector<ScopeStatisticsStruct>& scope_statistics) {
+		const double ratio = tsc_clock::nanoseconds_per_tick();
+		boost::lock_guard<boost::mutex> lock(statistics_mutex);
+
+		scope_statistics.resize(statistics.size());
+		std::size_t index = 0;
+		for (statistics_map::const_iterator it = statistics.begin(); it != statistics.end(); ++it, ++index) {
+			scope_statistics[index].Name = it->first;
+			scope_statistics[index].Count = it->second.Count;
+			scope_statistics[index].TotalNanoseconds = it->second.TotalTicks * ratio;
+			scope_statistics[index].MinNanoseconds = it->second.MinTicks * ratio;
+			scope_statistics[index].MaxNanoseconds = it->second.MaxTicks * ratio;
+		}
+	}
+
+	void reset_statistics() {
+		boost::lock_guard<boost::mutex> lock(statistics_mutex);
+		statistics.clear();
+	}
+
+	unsigned long long get_dropped_records() {
+		boost::lock_guard<boost::mutex> lock(buffers_mutex);
+		unsigned long long dropped = retired_dropped_records;
+
+		for (std::size_t i = 0; i < buffers.size(); i++) {
+			dropped += buffers[i]->get_dropped_records();
+		}
+
+		return dropped;
+	}
+};
+
+/*
+	    .     
+	( ,    ),      .
+*/
+class scope_timer {
+private:
+	const char* name;
+	boost::uint64_t begin;
+
+	scope_timer(const scope_timer&);
+	scope_timer& operator=(const scope_timer&);
+
+public:
+	explicit scope_timer(const char* scope_name) : name(scope_name), begin(tsc_clock::now()) {}
+
+	~scope_timer() {
+		boost::uint64_t end = tsc_clock::now();
+		scope_buffer* buffer = scope_registry::thread_buffer();
+		if (buffer) buffer->push(name, begin, end);
+	}
+};
+
+}}}
+
+#define BOOST_PERFOMANCE_SCOPE(name) \
+	::boost::perfomance::detail::scope_timer BOOST_JOIN(boost_perfomance_scope_, __LINE__)(name)
+
+#endif
@@ -0,0 +1,135 @@
+#ifndef BOOST_PERFOMANCE_SEQLOCK_HPP
+#define BOOST_PERFOMANCE_SEQLOCK_HPP
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <cstdlib>
+#include <cstring>
+#include <boost/config.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/atomic.hpp>
+#include <boost/scoped_array.hpp>
+#include <boost/type_traits/has_trivial_copy.hpp>
+#include <boost/static_assert.hpp>
+
+namespace boost { namespace perfomance { namespace detail {
+
+/*
+	     seqlock     . 
+	,          (shared_snapshot.hpp),
+	      ,    .
+*/
+inline void seqlock_write(boost::atomic<boost::uint32_t>& sequence, boost::atomic<boost::uint64_t>* words,
+	const void* data, std::size_t byte_count) {
+	const unsigned char* source = (const unsigned char*)data;
+	const std::size_t word_count = (byte_count + sizeof(boost::uint64_t) - 1) / sizeof(boost::uint64_t);
+	boost::uint32_t current = sequence.load(boost::memory_order_relaxed);
+
+	sequence.store(current + 1, boost::memory_order_relaxed);
+	boost::atomic_thread_fence(boost::memory_order_release);
+
+	for (std::size_t i = 0; i < word_count; i++) {
+		boost::uint64_t word = 0;
+		std::size_t offset = i * sizeof(boost::uint64_t);
+		std::size_t chunk = byte_count - offset < sizeof(word) ? byte_count - offset : sizeof(word);
+
+		std::memcpy(&word, source + offset, chunk);
+		words[i].store(word, boost::memory_order_relaxed);
+	}
+
+	sequence.store(current + 2, boost::memory_order_release);
+}
+
+/*
+	max_attempts     (0 -  ).  
+	     ,    ,
+	          .
+*/
+inline bool seqlock_read(const boost::atomic<boost::uint32_t>& sequence, const boost::atomic<boost::uint64_t>* words,
+	void* data, std::size_t byte_count, std::size_t max_attempts = 0) {
+	unsigned char* target = (unsigned char*)data;
+	const std::size_t word_count = (byte_count + sizeof(boost::uint64_t) - 1) / sizeof(boost::uint64_t);
+
+	for (std::size_t attempt = 1;; attempt++) {
+		if (max_attempts && attempt > max_attempts) return false;
+
+		boost::uint32_t before = sequence.load(boost::memory_order_acquire);
+		if (!before) return false;
+		if (before & 1) continue;
+
+		for (std::size_t i = 0; i < word_count; i++) {
+			boost::uint64_t word = words[i].load(boost::memory_order_relaxed);
+			std::size_t offset = i * sizeof(boost::uint64_t);
+			std::size_t chunk = byte_count - offset < sizeof(word) ? byte_count - offset : sizeof(word);
+
+			std::memcpy(target + offset, &word, chunk);
+		}
+
+		boost::atomic_thread_fence(boost::memory_order_acquire);
+		if (sequence.load(boost::memory_order_relaxed) == before) return true;
+	}
+}
+
+/*
+	Seqlock       .    
+	,        ,     
+	 (         ).
+
+	      ,      relaxed
+	,         C++  .
+*/
+template <class T>
+class seqlock {
+private:
+	BOOST_STATIC_ASSERT(boost::has_trivial_copy<T>::value);
+
+	typedef boost::atomic<boost::uint64_t> word_type;
+
+	BOOST_ALIGNMENT(64) boost::atomic<boost::uint32_t> sequence;
+	std::size_t element_count;
+	std::size_t word_count;
+	boost::scoped_array<word_type> words;
+
+	seqlock(const seqlock&);
+	seqlock& operator=(const seqlock&);
+
+public:
+	explicit seqlock(std::size_t count = 1) : sequence(0), element_count(count) {
+		word_count = (sizeof(T) * count + sizeof(boost::uint64_t) - 1) / sizeof(boost::uint64_t);
+		words.reset(new word_type[word_count ? word_count : 1]);
+
+		for (std::size_t i = 0; i < word_count; i++) {
+			words[i].store(0, boost::memory_order_relaxed);
+		}
+	}
+
+	std::size_t size() const {
+		return element_count;
+	}
+
+	/*
+		      
+	*/
+	bool is_published() const {
+		return sequence.load(boost::memory_order_acquire) != 0;
+	}
+
+	/*
+		    -
+	*/
+	void store(const T* values) {
+		seqlock_write(sequence, words.get(), values, sizeof(T) * element_count);
+	}
+
+	/*
+		 false,      
+	*/
+	bool load(T* values) const {
+		return seqlock_read(sequence, words.get(), values, sizeof(T) * element_count);
+	}
+};
+
+}}}
+#endif
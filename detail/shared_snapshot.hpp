@@ -0,0 +1,397 @@
+#ifndef BOOST_PERFOMANCE_SHARED_SNAPSHOT_HPP
+#define BOOST_PERFOMANCE_SHARED_SNAPSHOT_HPP
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <boost/cstdint.hpp>
+#include <boost/atomic.hpp>
+#include <boost/chrono.hpp>
+#include <boost/thread.hpp>
+#include <boost/container/vector.hpp>
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/interprocess/exceptions.hpp>
+#include "seqlock.hpp"
+
+namespace boost { namespace perfomance { namespace detail {
+
+/*
+	     ( POSIX - shm_open):
+
+		[SharedSegmentHeaderStruct][ seqlock][ ]
+
+	 - SharedSnapshotStruct     CoreCount    ,
+	  seqlock_write.       ,
+	Magic - ,     Magic   .
+	     Version.
+*/
+typedef struct {
+	char Magic[8];							// "BPRFSHM"
+	boost::uint32_t Version;
+	boost::uint32_t CoreCount;
+	boost::uint32_t PayloadSize;			//        
+	boost::uint32_t Reserved;
+	boost::uint64_t PeriodNanoseconds;		//   
+} SharedSegmentHeaderStruct;
+
+typedef struct {
+	boost::uint64_t Timestamp;				//  system_clock,  
+	boost::uint64_t SampleIndex;			//   
+	unsigned long long SwapLoad;
+	unsigned long long VirtualMemoryLoad;
+	float BaseLoad;
+	float Reserved;
+} SharedSnapshotStruct;
+
+namespace shared_layout {
+
+enum {
+	version = 1,
+	sequence_offset = 64,
+	words_offset = 128
+};
+
+/*
+	   ,      
+	  ,    
+*/
+enum {
+	read_attempts = 1 << 20
+};
+
+inline std::size_t payload_size(std::size_t core_count) {
+	return sizeof(SharedSnapshotStruct) + core_count * sizeof(float);
+}
+
+inline std::size_t word_count(std::size_t core_count) {
+	return (payload_size(core_count) + sizeof(boost::uint64_t) - 1) / sizeof(boost::uint64_t);
+}
+
+inline std::size_t segment_size(std::size_t core_count) {
+	return words_offset + word_count(core_count) * sizeof(boost::uint64_t);
+}
+
+inline bool check_header(const SharedSegmentHeaderStruct& header, std::size_t size) {
+	if (size < words_offset || std::memcmp(header.Magic, "BPRFSHM", 8) || header.Version != version) return false;
+	return header.PayloadSize == payload_size(header.CoreCount) && segment_size(header.CoreCount) <= size;
+}
+
+}
+
+/*
+	         , 
+	     shared_subscriber   . 
+	N ,      /proc/stat    
+	,   .       .
+
+	            (
+	),   ,    
+	 .   ;   ,  
+	 ,    .
+*/
+template <class CpuCounter, class MemoryCounter>
+class basic_shared_publisher {
+private:
+	CpuCounter cpu;
+	MemoryCounter memory;
+	boost::chrono::milliseconds period;
+	std::string segment_name;
+
+	boost::interprocess::shared_memory_object segment;
+	boost::interprocess::mapped_region region;
+	boost::atomic<boost::uint32_t>* sequence;
+	boost::atomic<boost::uint64_t>* words;
+
+	std::size_t core_count;
+	boost::container::vector<float> core_load;
+	boost::container::vector<boost::uint64_t> payload;
+	boost::uint64_t sample_index;
+	boost::thread publisher_thread;
+
+	basic_shared_publisher(const basic_shared_publisher&);
+	basic_shared_publisher& operator=(const basic_shared_publisher&);
+
+	bool attach_existing() {
+		try {
+			boost::interprocess::shared_memory_object existing(boost::interprocess::open_only, segment_name.c_str(), boost::interprocess::read_write);
+			boost::interprocess::mapped_region mapped(existing, boost::interprocess::read_write);
+
+			const SharedSegmentHeaderStruct* header = (const SharedSegmentHeaderStruct*)mapped.get_address();
+			if (!shared_layout::check_header(*header, mapped.get_size()) || header->CoreCount != core_count) return false;
+
+			segment.swap(existing);
+			region.swap(mapped);
+		} catch (const boost::interprocess::interprocess_exception&) {
+			return false;
+		}
+
+		unsigned char* base = (unsigned char*)region.get_address();
+		sequence = (boost::atomic<boost::uint32_t>*)(base + shared_layout::sequence_offset);
+		words = (boost::atomic<boost::uint64_t>*)(base + shared_layout::words_offset);
+		((SharedSegmentHeaderStruct*)base)->PeriodNanoseconds = period_nanoseconds();
+
+		/*
+			     
+		*/
+		boost::uint32_t current = sequence->load(boost::memory_order_relaxed);
+		if (current & 1) sequence->store(current + 1, boost::memory_order_release);
+		return true;
+	}
+
+	bool create_segment() {
+		boost::interprocess::shared_memory_object::remove(segment_name.c_str());
+
+		try {
+			boost::interprocess::shared_memory_object created(boost::interprocess::create_only, segment_name.c_str(), boost::interprocess::read_write);
+			created.truncate((boost::interprocess::offset_t)shared_layout::segment_size(core_count));
+			boost::interprocess::mapped_region mapped(created, boost::interprocess::read_write);
+
+			segment.swap(created);
+			region.swap(mapped);
+		} catch (const boost::interprocess::interprocess_exception&) {
+			return false;
+		}
+
+		unsigned char* base = (unsigned char*)region.get_address();
+		std::memset(base, 0, region.get_size());
+
+		sequence = new (base + shared_layout::sequence_offset) boost::atomic<boost::uint32_t>(0);
+		words = (boost::atomic<boost::uint64_t>*)(base + shared_layout::words_offset);
+		for (std::size_t i = 0; i < shared_layout::word_count(core_count); i++) {
+			new (&words[i]) boost::atomic<boost::uint64_t>(0);
+		}
+
+		SharedSegmentHeaderStruct* header = (SharedSegmentHeaderStruct*)base;
+		header->Version = shared_layout::version;
+		header->CoreCount = (boost::uint32_t)core_count;
+		header->PayloadSize = (boost::uint32_t)shared_layout::payload_size(core_count);
+		header->PeriodNanoseconds = period_nanoseconds();
+
+		boost::atomic_thread_fence(boost::memory_order_release);
+		std::memcpy(header->Magic, "BPRFSHM", 8);
+		return true;
+	}
+
+	boost::uint64_t period_nanoseconds() const {
+		return (boost::uint64_t)boost::chrono::duration_cast<boost::chrono::nanoseconds>(period).count();
+	}
+
+	void publish() {
+		float base_load = 0.f;
+		if (!cpu.get_load_per_core(core_load, base_load) || core_load.size() != core_count) return;
+
+		SharedSnapshotStruct snapshot;
+		std::memset(&snapshot, 0, sizeof(snapshot));
+		snapshot.Timestamp = (boost::uint64_t)boost::chrono::duration_cast<boost::chrono::nanoseconds>(
+			boost::chrono::system_clock::now().time_since_epoch()).count();
+		snapshot.SampleIndex = ++sample_index;
+		snapshot.BaseLoad = base_load;
+
+		if (!memory.get_system_memory_load(snapshot.SwapLoad, snapshot.VirtualMemoryLoad)) {
+			snapshot.SwapLoad = 0;
+			snapshot.VirtualMemoryLoad = 0;
+		}
+
+		unsigned char* target = (unsigned char*)payload.data();
+		std::memcpy(target, &snapshot, sizeof(snapshot));
+		std::memcpy(target + sizeof(snapshot), core_load.data(), core_load.size() * sizeof(float));
+
+		seqlock_write(*sequence, words, target, shared_layout::payload_size(core_count));
+	}
+
+	void publisher_proc() {
+		boost::chrono::steady_clock::time_point next_tick = boost::chrono::steady_clock::now();
+
+		try {
+			for (;;) {
+				next_tick += period;
+				boost::this_thread::sleep_until(next_tick);
+				publish();
+			}
+		} catch (const boost::thread_interrupted&) {
+		}
+	}
+
+public:
+	/*
+		name -   ( Linux -   /dev/shm). ,   ,
+		  is_open().
+	*/
+	explicit basic_shared_publisher(const char* name, boost::chrono::milliseconds sample_period = boost::chrono::milliseconds(100))
+		: period(sample_period), segment_name(name), sequence(NULL), words(NULL), core_count(0), sample_index(0) {
+		/*
+			         
+		*/
+		if (!cpu.get_load_per_core(core_load) || core_load.empty()) return;
+		core_count = core_load.size();
+
+		if (!attach_existing() && !create_segment()) {
+			sequence = NULL;
+			return;
+		}
+
+		payload.resize(shared_layout::word_count(core_count));
+		publisher_thread = boost::thread(&basic_shared_publisher::publisher_proc, this);
+	}
+
+	/*
+		  ,       
+		 
+	*/
+	~basic_shared_publisher() {
+		if (publisher_thread.joinable()) {
+			publisher_thread.interrupt();
+			publisher_thread.join();
+		}
+
+		if (sequence) boost::interprocess::shared_memory_object::remove(segment_name.c_str());
+	}
+
+	bool is_open() const {
+		return sequence != NULL;
+	}
+
+	std::size_t get_core_count() const {
+		return core_count;
+	}
+};
+
+/*
+	  ,   basic_shared_publisher,   .
+	 -    seqlock,      , 
+	          .
+*/
+class shared_subscriber {
+private:
+	boost::interprocess::shared_memory_object segment;
+	boost::interprocess::mapped_region region;
+	const SharedSegmentHeaderStruct* header;
+	const boost::atomic<boost::uint32_t>* sequence;
+	const boost::atomic<boost::uint64_t>* words;
+
+	shared_subscriber(const shared_subscriber&);
+	shared_subscriber& operator=(const shared_subscriber&);
+
+public:
+	shared_subscriber() : header(NULL), sequence(NULL), words(NULL) {}
+
+	explicit shared_subscriber(const char* name) : header(NULL), sequence(NULL), words(NULL) {
+		open(name);
+	}
+
+	/*
+		  ,     
+	*/
+	bool open(const char* name) {
+		close();
+
+		try {
+			boost::interprocess::shared_memory_object existing(boost::interprocess::open_only, name, boost::interprocess::read_only);
+			boost::interprocess::mapped_region mapped(existing, boost::interprocess::read_only);
+			if (!shared_layout::check_header(*(const SharedSegmentHeaderStruct*)mapped.get_address(), mapped.get_size())) return false;
+
+			segment.swap(existing);
+			region.swap(mapped);
+		} catch (const boost::interprocess::interprocess_exception&) {
+			return false;
+		}
+
+		const unsigned char* base = (const unsigned char*)region.get_address();
+		header = (const SharedSegmentHeaderStruct*)base;
+		sequence = (const boost::atomic<boost::uint32_t>*)(base + shared_layout::sequence_offset);
+		words = (const boost::atomic<boost::uint64_t>*)(base + shared_layout::words_offset);
+		return true;
+	}
+
+	void close() {
+		boost::interprocess::mapped_region().swap(region);
+		boost::interprocess::shared_memory_object().swap(segment);
+		header = NULL;
+	}
+
+	bool is_open() const {
+		return header != NULL;
+	}
+
+	std::size_t get_core_count() const {
+		return header ? header->CoreCount : 0;
+	}
+
+	/*
+		 false,      ,    
+		          . 
+		      ,   subscriber
+		    .
+	*/
+	bool get_snapshot(SharedSnapshotStruct& shared_snapshot) const {
+		return header && seqlock_read(*sequence, words, &shared_snapshot, sizeof(shared_snapshot), shared_layout::read_attempts);
+	}
+
+	bool get_load(float& base_load) const {
+		SharedSnapshotStruct shared_snapshot;
+		if (!get_snapshot(shared_snapshot)) return false;
+		base_load = shared_snapshot.BaseLoad;
+		return true;
+	}
+
+	/*
+		     vector_load,     
+		 ,         
+	*/
+	bool get_load_per_core(boost::container::vector<float>& vector_load, float& base_load) const {
+		if (!header) return false;
+
+		const std::size_t prefix = sizeof(SharedSnapshotStruct) / sizeof(float);
+		vector_load.resize(shared_layout::word_count(header->CoreCount) * sizeof(boost::uint64_t) / sizeof(float));
+		if (!seqlock_read(*sequence, words, vector_load.data(), header->PayloadSize, shared_layout::read_attempts)) return false;
+
+		SharedSnapshotStruct shared_snapshot;
+		std::memcpy(&shared_snapshot, vector_load.data(), sizeof(shared_snapshot));
+		base_load = shared_snapshot.BaseLoad;
+
+		std::memmove(vector_load.data(), vector_load.data() + prefix, header->CoreCount * sizeof(float));
+		vector_load.resize(header->CoreCount);
+		return true;
+	}
+
+	bool get_load_per_core(boost::container::vector<float>& vector_load) const {
+		float base_load = 0.f;
+		return get_load_per_core(vector_load, base_load);
+	}
+
+	bool get_swap_load(unsigned long long& swap_load) const {
+		SharedSnapshotStruct shared_snapshot;
+		if (!get_snapshot(shared_snapshot)) return false;
+		swap_load = shared_snapshot.SwapLoad;
+		return true;
+	}
+
+	bool get_vmemory_load(unsigned long long& mem_load) const {
+		SharedSnapshotStruct shared_snapshot;
+		if (!get_snapshot(shared_snapshot)) return false;
+		mem_load = shared_snapshot.VirtualMemoryLoad;
+		return true;
+	}
+
+	/*
+		         
+		,   
+	*/
+	bool is_stale(unsigned int missed_periods = 3) const {
+		SharedSnapshotStruct shared_snapshot;
+		if (!get_snapshot(shared_snapshot)) return true;
+
+		boost::uint64_t now = (boost::uint64_t)boost::chrono::duration_cast<boost::chrono::nanoseconds>(
+			boost::chrono::system_clock::now().time_since_epoch()).count();
+		return now > shared_snapshot.Timestamp && now - shared_snapshot.Timestamp > header->PeriodNanoseconds * missed_periods;
+	}
+};
+
+}}}
+#endif
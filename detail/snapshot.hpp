@@ -0,0 +1,272 @@
+#ifndef BOOST_PERFOMANCE_SNAPSHOT_HPP
+#define BOOST_PERFOMANCE_SNAPSHOT_HPP
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <cstdlib>
+#include <tuple>
+#include <boost/cstdint.hpp>
+#include <boost/chrono.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/lock_guard.hpp>
+#include <boost/container/vector.hpp>
+#include <boost/mp11/algorithm.hpp>
+#include <boost/mp11/tuple.hpp>
+#include "platform.hpp"
+
+#ifdef __linux__
+#include "linux/network_counter.hpp"
+#endif
+
+namespace boost { namespace perfomance { namespace detail {
+
+/*
+	 -    ,       
+	  .       ( 
+	    ),         .
+*/
+namespace sources {
+
+class cpu_source {
+private:
+	platform::cpu_counter counter;
+
+public:
+	boost::container::vector<float> core_load;
+	float base_load;
+
+	cpu_source() : base_load(0.f) {
+		/*
+			          
+		*/
+		counter.get_load_per_core(core_load);
+	}
+
+	bool refresh() {
+		return counter.get_load_per_core(core_load, base_load) && !core_load.empty();
+	}
+};
+
+class system_memory_source {
+private:
+	platform::memory_counter counter;
+
+public:
+	unsigned long long swap_load;
+	unsigned long long vmemory_load;
+
+	system_memory_source() : swap_load(0), vmemory_load(0) {}
+
+	bool refresh() {
+		return counter.get_system_memory_load(swap_load, vmemory_load);
+	}
+};
+
+class process_memory_source {
+private:
+	platform::memory_counter counter;
+
+public:
+	unsigned long long swap_load;
+	unsigned long long vmemory_load;
+
+	process_memory_source() : swap_load(0), vmemory_load(0) {}
+
+	bool refresh() {
+		return counter.get_process_swap_load(swap_load) && counter.get_process_vmemory_load(vmemory_load);
+	}
+};
+
+#ifdef __linux__
+class hardware_source {
+private:
+	platform::hw_counter counter;
+
+public:
+	platform::HardwareCountersStruct counters;
+
+	hardware_source() : counter(platform::eProcess) {
+		counters = platform::HardwareCountersStruct();
+	}
+
+	bool refresh() {
+		return counter.get_counters(counters);
+	}
+};
+
+/*
+	  TCP/UDP  /proc/net/snmp  /proc/net/netstat. 
+	   ,      .
+*/
+class network_source {
+private:
+	linux_::netword_counter counter;
+
+public:
+	linux_::NetworkGlobalStatus status;
+
+	network_source() {
+		status = linux_::NetworkGlobalStatus();
+		counter.get_global_network_info(status);
+	}
+
+	bool refresh() {
+		return counter.get_global_network_info(status);
+	}
+};
+#endif
+
+}
+
+/*
+	  processor::snapshot.       POD-
+	 ,     .       .
+*/
+namespace metrics {
+
+struct cpu_load {
+	typedef sources::cpu_source source_type;
+	typedef struct {
+		float CpuLoad;
+	} value_type;
+
+	static void extract(const source_type& source, value_type& value) {
+		value.CpuLoad = source.base_load;
+	}
+};
+
+template <std::size_t MaxCores>
+struct cpu_core_load {
+	typedef sources::cpu_source source_type;
+	typedef struct {
+		unsigned long CoreCount;
+		float CoreLoad[MaxCores];
+	} value_type;
+
+	static void extract(const source_type& source, value_type& value) {
+		std::size_t core_count = source.core_load.size() < MaxCores ? source.core_load.size() : MaxCores;
+
+		value.CoreCount = (unsigned long)core_count;
+		for (std::size_t i = 0; i < core_count; i++) {
+			value.CoreLoad[i] = source.core_load[i];
+		}
+	}
+};
+
+struct system_memory {
+	typedef sources::system_memory_source source_type;
+	typedef struct {
+		unsigned long long SwapLoad;
+		unsigned long long VirtualMemoryLoad;
+	} value_type;
+
+	static void extract(const source_type& source, value_type& value) {
+		value.SwapLoad = source.swap_load;
+		value.VirtualMemoryLoad = source.vmemory_load;
+	}
+};
+
+struct process_memory {
+	typedef sources::process_memory_source source_type;
+	typedef struct {
+		unsigned long long ProcessSwapLoad;
+		unsigned long long ProcessVirtualMemoryLoad;
+	} value_type;
+
+	static void extract(const source_type& source, value_type& value) {
+		value.ProcessSwapLoad = source.swap_load;
+		value.ProcessVirtualMemoryLoad = source.vmemory_load;
+	}
+};
+
+#ifdef __linux__
+struct hardware {
+	typedef sources::hardware_source source_type;
+	typedef struct {
+		platform::HardwareCountersStruct Hardware;
+	} value_type;
+
+	static void extract(const source_type& source, value_type& value) {
+		value.Hardware = source.counters;
+	}
+};
+
+struct network {
+	typedef sources::network_source source_type;
+	typedef struct {
+		linux_::NetworkGlobalStatus Network;
+	} value_type;
+
+	static void extract(const source_type& source, value_type& value) {
+		value.Network = source.status;
+	}
+};
+#endif
+
+}
+
+/*
+	 :        ,  
+	     ,  .
+*/
+template <class... Metrics>
+struct snapshot_result : Metrics::value_type... {
+	boost::uint64_t Timestamp;		//      
+};
+
+template <class... Metrics>
+class snapshot_collector {
+private:
+	typedef boost::mp11::mp_unique<boost::mp11::mp_list<typename Metrics::source_type...> > source_list;
+	typedef boost::mp11::mp_rename<source_list, std::tuple> source_tuple;
+
+	boost::mutex collector_mutex;
+	source_tuple sources;
+
+	struct refresh_source {
+		bool& complete;
+
+		explicit refresh_source(bool& complete_flag) : complete(complete_flag) {}
+
+		template <class Source>
+		void operator()(Source& source) const {
+			if (!source.refresh()) complete = false;
+		}
+	};
+
+	template <class Metric>
+	void extract(snapshot_result<Metrics...>& result) const {
+		typedef boost::mp11::mp_find<source_list, typename Metric::source_type> source_index;
+		Metric::extract(std::get<source_index::value>(sources), static_cast<typename Metric::value_type&>(result));
+	}
+
+	snapshot_collector() {}
+
+public:
+	static snapshot_collector& instance() {
+		static snapshot_collector* collector = new snapshot_collector();
+		return *collector;
+	}
+
+	/*
+		    ,     
+		  ,        
+	*/
+	bool collect(snapshot_result<Metrics...>& result) {
+		boost::lock_guard<boost::mutex> lock(collector_mutex);
+		bool complete = true;
+
+		boost::mp11::tuple_for_each(sources, refresh_source(complete));
+		result.Timestamp = (boost::uint64_t)boost::chrono::duration_cast<boost::chrono::nanoseconds>(
+			boost::chrono::steady_clock::now().time_since_epoch()).count();
+
+		int expand[] = { 0, (extract<Metrics>(result), 0)... };
+		(void)expand;
+		return complete;
+	}
+};
+
+}}}
+#endif
@@ -0,0 +1,84 @@
+#ifndef BOOST_PERFOMANCE_STRING_TABLE_HPP
+#define BOOST_PERFOMANCE_STRING_TABLE_HPP
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <cstdlib>
+#include <cstring>
+#include <boost/cstdint.hpp>
+#include <boost/container/vector.hpp>
+#include "open_hash_map.hpp"
+
+namespace boost { namespace perfomance { namespace detail {
+
+/*
+	  .        
+	,       .  0    .
+*/
+class string_table {
+private:
+	boost::container::vector<char> storage;
+	boost::container::vector<std::size_t> offsets;
+	open_hash_map<unsigned long> lookup;
+
+	static boost::uint64_t hash(const char* string, std::size_t length) {
+		boost::uint64_t ret_value = 0xcbf29ce484222325ull;
+		for (std::size_t i = 0; i < length; i++) {
+			ret_value ^= (unsigned char)string[i];
+			ret_value *= 0x100000001b3ull;
+		}
+
+		return ret_value;
+	}
+
+	bool equals(unsigned long id, const char* string, std::size_t length) const {
+		const char* stored = &storage[offsets[id]];
+		return std::strlen(stored) == length && !std::memcmp(stored, string, length);
+	}
+
+public:
+	string_table() {
+		intern("", 0);
+	}
+
+	std::size_t size() const {
+		return offsets.size();
+	}
+
+	/*
+		  ,     .  
+		         .
+	*/
+	unsigned long intern(const char* string, std::size_t length) {
+		boost::uint64_t key = hash(string, length);
+
+		for (;;) {
+			bool inserted = false;
+			unsigned long& id = lookup.insert(key, inserted);
+
+			if (!inserted) {
+				if (equals(id, string, length)) return id;
+				key++;
+				continue;
+			}
+
+			id = (unsigned long)offsets.size();
+			offsets.push_back(storage.size());
+			storage.insert(storage.end(), string, string + length);
+			storage.push_back('\0');
+			return id;
+		}
+	}
+
+	/*
+		     intern
+	*/
+	const char* get(unsigned long id) const {
+		return id < offsets.size() ? &storage[offsets[id]] : "";
+	}
+};
+
+}}}
+#endif
@@ -10,6 +10,7 @@
 #include <boost/function.hpp>
 #include <boost/container/vector.hpp>
 #include <boost/thread.hpp>
+#include "../load_kernel.hpp"
 
 namespace boost { namespace perfomance { namespace detail { namespace windows {
 
@@ -47,29 +48,30 @@ private:
 	typedef long(__stdcall NtQuerySystemInformation_t)(int, void*, unsigned long, unsigned long*);
 	NtQuerySystemInformation_t* pNtQuerySystemInformation;
 
-	boost::container::vector<long long> prev_idle_time;
-	boost::container::vector<long long> prev_user_time;
-	boost::container::vector<long long> prev_kernel_time;
+	/*
+		NtQuerySystemInformation   ,     
+		 :      (KernelTime    
+		IdleTime,    -  KernelTime + UserTime)
+	*/
 	boost::container::vector<SYSTEM_PROCESSOR_PERFORMANCE_INFORMATION> perf_info;
+	boost::container::vector<boost::uint64_t> core_idle_time;
+	boost::container::vector<boost::uint64_t> core_total_time;
+	boost::container::vector<boost::uint64_t> prev_core_idle_time;
+	boost::container::vector<boost::uint64_t> prev_core_total_time;
+	boost::container::vector<float> core_load;	//  get_load,      
 
-	inline float calculate_load(unsigned long current_index, long long idle_time, long long kernel_time, long long user_time) {
-		float ret_value = (
-			(float)(idle_time - prev_idle_time[current_index]) / 
-			(float)(
-			(kernel_time + user_time) - 
-			(prev_kernel_time[current_index] + prev_user_time[current_index])
-			)
-		);
-
-		prev_idle_time[current_index] = idle_time;
-		prev_user_time[current_index] = user_time;
-		prev_kernel_time[current_index] = kernel_time;
+	/*
+		        .  
+		(  )   ,   NaN.
+	*/
+	float calculate_load(float* load) {
+		for (size_t i = 0; i < cpu_count; i++) {
+			core_idle_time[i] = (boost::uint64_t)perf_info[i].IdleTime.QuadPart;
+			core_total_time[i] = (boost::uint64_t)(perf_info[i].KernelTime.QuadPart + perf_info[i].UserTime.QuadPart);
+		}
 
-		/*
-			         
-			  
-		*/
-		return 1.f - ret_value;
+		CoreLoadStateStruct state = { &core_idle_time[0], &core_total_time[0], &prev_core_idle_time[0], &prev_core_total_time[0] };
+		return calculate_core_load(state, load, cpu_count);
 	}
 
 	inline bool is_nt_failed(long result) {
@@ -113,33 +115,37 @@ public:
 					      - 
 				*/
 				perf_info.resize(cpu_count);
-				prev_idle_time.resize(cpu_count);
-				prev_kernel_time.resize(cpu_count);
-				prev_user_time.resize(cpu_count);
+				core_idle_time.resize(cpu_count);
+				core_total_time.resize(cpu_count);
+				prev_core_idle_time.resize(cpu_count);
+				prev_core_total_time.resize(cpu_count);
+				core_load.resize(cpu_count);
 			}
 		}
 	}
 
+	unsigned long get_cpu_count() const {
+		return cpu_count;
+	}
+
 	bool get_load(float& base_load) {
 		if (!get_load_per_core_internal()) return false;
-		base_load = 0.f;
-
-		for (size_t i = 0; i < cpu_count; i++) {
-			base_load += calculate_load(i, perf_info[i].IdleTime.QuadPart, perf_info[i].KernelTime.QuadPart, perf_info[i].UserTime.QuadPart);
-		}	
-
-		base_load /= cpu_count;
+		base_load = calculate_load(&core_load[0]);
 		return true;
 	}
 
 	bool get_load_per_core(boost::container::vector<float>& vector_load) {
+		float base_load = 0.f;
+		return get_load_per_core(vector_load, base_load);
+	}
+
+	/*
+		         
+	*/
+	bool get_load_per_core(boost::container::vector<float>& vector_load, float& base_load) {
 		if (!get_load_per_core_internal()) return false;
 		vector_load.resize(cpu_count);
-
-		for (size_t i = 0; i < cpu_count; i++) {
-			vector_load[i] = calculate_load(i, perf_info[i].IdleTime.QuadPart, perf_info[i].KernelTime.QuadPart, perf_info[i].UserTime.QuadPart);
-		}
-
+		base_load = calculate_load(&vector_load[0]);
 		return true;
 	}
 };
@@ -14,6 +14,8 @@
 #include <boost/dll/import.hpp>
 #include <boost/function.hpp>
 #include <boost/container/vector.hpp>
+#include <boost/container/flat_map.hpp>
+#include <boost/winapi/process.hpp>
 #include <boost/thread.hpp>
 #include <boost/process.hpp>
 
@@ -49,11 +51,28 @@ private:
 	typedef boost::winapi::BOOL_(__stdcall GetProcessMemoryInfo_t)(void*, void*, unsigned long);
 	typedef boost::winapi::BOOL_(__stdcall GlobalMemoryStatusEx_t)(void*);
 
+	/*
+		       ,   
+		  . ,   , .
+	*/
+	typedef struct {
+		boost::winapi::HANDLE_ Handle;
+		unsigned long long Generation;
+	} CachedProcessStruct;
+
+	typedef boost::container::flat_map<int, CachedProcessStruct> process_handle_table;
+
 	GetProcessMemoryInfo_t* pGetProcessMemoryInfo;
 	GlobalMemoryStatusEx_t* pGlobalMemoryStatusEx;
 	PROCESS_MEMORY_COUNTERS memory_counters = {};
 	MEMORYSTATUSEX memory_status = {};
 
+	unsigned long long batch_generation;
+	process_handle_table process_handles;
+
+	memory_counter(const memory_counter&);
+	memory_counter& operator=(const memory_counter&);
+
 	bool get_memory_system_info(boost::winapi::HANDLE_ hProcess) {
 		if (!pGetProcessMemoryInfo) return false;
 		return !!pGetProcessMemoryInfo(hProcess, &memory_counters, sizeof(PROCESS_MEMORY_COUNTERS));
@@ -127,6 +146,8 @@ private:
 				return false;
 			}
 		}
+
+		return true;
 	}
 
 	bool get_system_memory_counter(int process_id) {
@@ -140,8 +161,38 @@ private:
 		return !!boost::winapi::CloseHandle(hProcess);
 	}
 
+	/*
+		    ,   PID  
+		  .     
+		,      -  PID .
+	*/
+	bool get_cached_process_handle(int process_id, boost::winapi::HANDLE_& hProcess) {
+		const boost::winapi::DWORD_ still_active = 259;
+		CachedProcessStruct& cached = process_handles[process_id];
+
+		cached.Generation = batch_generation;
+		if (cached.Handle) {
+			boost::winapi::DWORD_ exit_code = 0;
+			if (boost::winapi::GetExitCodeProcess(cached.Handle, &exit_code) && exit_code == still_active) {
+				hProcess = cached.Handle;
+				return true;
+			}
+
+			boost::winapi::CloseHandle(cached.Handle);
+			cached.Handle = NULL;
+		}
+
+		if (!open_process_query_information(process_id, cached.Handle)) {
+			process_handles.erase(process_id);
+			return false;
+		}
+
+		hProcess = cached.Handle;
+		return true;
+	}
+
 public:
-	memory_counter() : pGetProcessMemoryInfo(NULL), pGlobalMemoryStatusEx(NULL) {
+	memory_counter() : pGetProcessMemoryInfo(NULL), pGlobalMemoryStatusEx(NULL), batch_generation(0) {
 		/*
 			     ,    
 		*/
@@ -149,6 +200,12 @@ public:
 		load_get_process_memory_info_procs();
 	}
 
+	~memory_counter() {
+		for (process_handle_table::iterator it = process_handles.begin(); it != process_handles.end(); ++it) {
+			boost::winapi::CloseHandle(it->second.Handle);
+		}
+	}
+
 	/*
 		     
 	*/
@@ -164,6 +221,16 @@ public:
 		return true;
 	}
 
+	/*
+		get_swap_load  get_vmemory_load    GlobalMemoryStatusEx
+	*/
+	bool get_system_memory_load(unsigned long long& swap_load, unsigned long long& vmemory_load) {
+		if (!global_memory_status()) return false;
+		swap_load = memory_status.ullTotalPageFile - memory_status.ullAvailPageFile;
+		vmemory_load = memory_status.ullTotalVirtual - memory_status.ullAvailVirtual;
+		return true;
+	}
+
 	/*
 		      
 	*/
@@ -208,6 +275,52 @@ public:
 		mem_load = memory_counters.WorkingSetSize;
 		return true;
 	}
+
+	/*
+		   .     
+		,       OpenProcess  CloseHandle 
+		 .     mem_loads  0,  
+		 false.
+	*/
+	bool get_process_vmemory_load(const int* process_ids, std::size_t process_count, unsigned long long* mem_loads) {
+		bool ret_value = true;
+		batch_generation++;
+
+		for (std::size_t i = 0; i < process_count; i++) {
+			boost::winapi::HANDLE_ hProcess = NULL;
+
+			mem_loads[i] = 0;
+			if (!get_cached_process_handle(process_ids[i], hProcess) || !get_memory_system_info(hProcess)) {
+				ret_value = false;
+				continue;
+			}
+
+			mem_loads[i] = memory_counters.WorkingSetSize;
+		}
+
+		/*
+			  ,       
+		*/
+		if (process_handles.size() > process_count) {
+			/*
+				     :      
+				 ,    erase   flat_map
+			*/
+			process_handle_table requested_handles;
+			requested_handles.reserve(process_count);
+			for (process_handle_table::iterator it = process_handles.begin(); it != process_handles.end(); ++it) {
+				if (it->second.Generation != batch_generation) {
+					boost::winapi::CloseHandle(it->second.Handle);
+				} else {
+					requested_handles.insert(requested_handles.end(), *it);
+				}
+			}
+
+			process_handles.swap(requested_handles);
+		}
+
+		return ret_value;
+	}
 };
 
 }}}}
@@ -193,6 +193,12 @@ private:
 	typedef boost::winapi::DWORD_(__stdcall GetTcpStatisticsEx_t)(_MIB_TCPSTATS_LH*, unsigned long);
 	typedef boost::winapi::DWORD_(__stdcall GetUdpStatisticsEx_t)(_MIB_UDPSTATS*, unsigned long);
 
+	/*
+		      ,  
+		      
+	*/
+	boost::dll::shared_library iphlpapi_library;
+
 	GetExtendedTcpTable_t* pGetExtendedTcpTable = NULL;
 	GetPerTcpConnectionEStats_t* pGetPerTcpConnectionEStats = NULL;
 	GetPerTcp6ConnectionEStats_t* pGetPerTcp6ConnectionEStats = NULL;
@@ -200,9 +206,10 @@ private:
 	GetUdpStatisticsEx_t* pGetUdpStatistics = NULL;
 
 	bool load_proc_for_vista_functions() {
-		boost::dll::shared_library lib("Iphlpapi.dll", boost::dll::load_mode::search_system_folders);
-		if (!lib.is_loaded()) return false;
+		iphlpapi_library.load("Iphlpapi.dll", boost::dll::load_mode::search_system_folders);
+		if (!iphlpapi_library.is_loaded()) return false;
 
+		boost::dll::shared_library& lib = iphlpapi_library;
 		pGetExtendedTcpTable = &lib.get<GetExtendedTcpTable_t>("GetExtendedTcpTable");
 		pGetPerTcpConnectionEStats = &lib.get<GetPerTcpConnectionEStats_t>("GetPerTcpConnectionEStats");
 		pGetPerTcp6ConnectionEStats = &lib.get<GetPerTcp6ConnectionEStats_t>("GetPerTcp6ConnectionEStats");
@@ -236,6 +243,14 @@ private:
 		return retValue == boost::winapi::NO_ERROR_;
 	}
 
+public:
+	netword_counter() {
+		load_proc_for_vista_functions();
+	}
+
+	/*
+		ConnectionType -   (AF_INET  AF_INET6)
+	*/
 	bool get_global_network_info(NetworkGlobalStatus& global_status, unsigned long ConnectionType) {
 		_MIB_TCPSTATS_LH TcpStats = {};
 		_MIB_UDPSTATS UdpStats = {};
@@ -249,8 +264,6 @@ private:
 		global_status.CountOfUDPListeners = UdpStats.dwNumAddrs;
 		return true;
 	}
-
-
 };
 
 }}}}
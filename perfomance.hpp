@@ -1,12 +1,94 @@
 #pragma once
 
+#include <boost/chrono.hpp>
+#include <boost/container/vector.hpp>
+#include "detail/scope_timer.hpp"
+#include "detail/snapshot.hpp"
+#include "detail/recorder.hpp"
+#include "detail/shared_snapshot.hpp"
+#include "detail/heap_counter.hpp"
+#include "detail/platform.hpp"
+
+/*
+	  HTTP  Boost.Asio,     
+*/
+#ifdef BOOST_PERFOMANCE_WITH_EXPORTER
+#include "detail/openmetrics_exporter.hpp"
+#endif
+
 namespace boost {
 	namespace perfomance {
+		typedef detail::ScopeStatisticsStruct ScopeStatisticsStruct;
+		namespace metrics = detail::metrics;
+		typedef detail::recorder recorder;
+		typedef detail::record_reader record_reader;
+		typedef detail::basic_shared_publisher<detail::platform::cpu_counter, detail::platform::memory_counter> shared_publisher;
+		typedef detail::shared_subscriber shared_subscriber;
+		typedef detail::HeapStatisticsStruct HeapStatisticsStruct;
+		typedef detail::heap_counter heap_counter;
+#ifdef BOOST_PERFOMANCE_WITH_EXPORTER
+		typedef detail::openmetrics_exporter openmetrics_exporter;
+#endif
+
+		template <class... Metrics>
+		using snapshot_result = detail::snapshot_result<Metrics...>;
+
+		/*
+			      .    
+			BOOST_PERFOMANCE_SCOPE("name")     ,  processor
+			 -    .
+		*/
 		class processor {
 		private:
-
+			detail::scope_registry& registry;
 
 		public:
+			processor() : registry(detail::scope_registry::instance()) {}
+
+			void start_collector(boost::chrono::milliseconds period = boost::chrono::milliseconds(100)) {
+				registry.start_collector(period);
+			}
+
+			void stop_collector() {
+				registry.stop_collector();
+			}
+
+			/*
+				    ,   
+			*/
+			void collect() {
+				registry.collect();
+			}
+
+			void get_scope_statistics(boost::container::vector<ScopeStatisticsStruct>& scope_statistics) {
+				registry.get_statistics(scope_statistics);
+			}
+
+			void reset_scope_statistics() {
+				registry.reset_statistics();
+			}
+
+			/*
+				 ,  -   
+			*/
+			unsigned long long get_dropped_scopes() {
+				return registry.get_dropped_records();
+			}
+
+			/*
+				      , :
+
+					snapshot_result<metrics::cpu_load, metrics::process_memory> result;
+					processor.snapshot(result);
+
+				       ,   ,
+				   ,        .
+				 false,         .
+			*/
+			template <class... Metrics>
+			bool snapshot(snapshot_result<Metrics...>& result) {
+				return detail::snapshot_collector<Metrics...>::instance().collect(result);
+			}
 		};
 	}
 }
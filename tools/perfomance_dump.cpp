@@ -0,0 +1,94 @@
+/*
+	 ,  boost::perfomance::recorder.
+
+		perfomance_dump <> [--info] [--from <unix >] [--to <unix >] [--limit <N>]
+
+	 --info  CSV:       .  
+	  -       .
+*/
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <boost/cstdint.hpp>
+#include <boost/container/vector.hpp>
+#include "../detail/recorder.hpp"
+
+namespace {
+
+void print_usage() {
+	std::fprintf(stderr, "usage: perfomance_dump <file> [--info] [--from <unix seconds>] [--to <unix seconds>] [--limit <count>]\n");
+}
+
+void print_info(const boost::perfomance::detail::record_reader& reader) {
+	const boost::perfomance::detail::RecordHeaderStruct* header = reader.get_header();
+	boost::uint64_t first = 0;
+	boost::uint64_t last = 0;
+
+	std::printf("channels:        %u\n", header->ChannelCount);
+	std::printf("quantum:         %g\n", header->Quantum);
+	std::printf("time resolution: %llu ns\n", (unsigned long long)header->TimeResolution);
+	std::printf("blocks:          %zu of %u, %u bytes each\n", reader.get_block_count(), header->BlockCount, header->BlockSize);
+
+	if (reader.get_time_range(first, last)) {
+		std::printf("time range:      %.3f - %.3f (%.1f s)\n", first * 1e-9, last * 1e-9, (last - first) * 1e-9);
+	}
+}
+
+}
+
+int main(int argc, char** argv) {
+	if (argc < 2) {
+		print_usage();
+		return 2;
+	}
+
+	bool info = false;
+	boost::uint64_t from = 0;
+	boost::uint64_t to = ~(boost::uint64_t)0;
+	unsigned long long limit = ~0ull;
+
+	for (int i = 2; i < argc; i++) {
+		if (!std::strcmp(argv[i], "--info")) {
+			info = true;
+		} else if (!std::strcmp(argv[i], "--from") && i + 1 < argc) {
+			from = (boost::uint64_t)(std::strtod(argv[++i], NULL) * 1e9);
+		} else if (!std::strcmp(argv[i], "--to") && i + 1 < argc) {
+			to = (boost::uint64_t)(std::strtod(argv[++i], NULL) * 1e9);
+		} else if (!std::strcmp(argv[i], "--limit") && i + 1 < argc) {
+			limit = std::strtoull(argv[++i], NULL, 10);
+		} else {
+			print_usage();
+			return 2;
+		}
+	}
+
+	boost::perfomance::detail::record_reader reader;
+	if (!reader.open(argv[1])) {
+		std::fprintf(stderr, "perfomance_dump: %s is not a recording\n", argv[1]);
+		return 1;
+	}
+
+	if (info) {
+		print_info(reader);
+		return 0;
+	}
+
+	if (from && !reader.seek(from)) return 0;
+
+	boost::container::vector<double> values(reader.get_channel_count());
+	boost::uint64_t timestamp = 0;
+
+	std::printf("timestamp");
+	for (std::size_t i = 0; i < values.size(); i++) std::printf(",ch%zu", i);
+	std::printf("\n");
+
+	for (unsigned long long count = 0; count < limit && reader.next(timestamp, values.data()); count++) {
+		if (timestamp > to) break;
+
+		std::printf("%llu", (unsigned long long)timestamp);
+		for (std::size_t i = 0; i < values.size(); i++) std::printf(",%g", values[i]);
+		std::printf("\n");
+	}
+
+	return 0;
+}